@@ -174,6 +174,8 @@
 /* ldr and str */
 #define EOP_LDR_IMM2(cond,rd,rn,offset_12)  EOP_C_AM2_IMM(cond,1,0,1,rn,rd,offset_12)
 #define EOP_LDRB_IMM2(cond,rd,rn,offset_12) EOP_C_AM2_IMM(cond,1,1,1,rn,rd,offset_12)
+#define EOP_STR_IMM2(cond,rd,rn,offset_12)  EOP_C_AM2_IMM(cond,1,0,0,rn,rd,offset_12)
+#define EOP_STRB_IMM2(cond,rd,rn,offset_12) EOP_C_AM2_IMM(cond,1,1,0,rn,rd,offset_12)
 
 #define EOP_LDR_IMM(   rd,rn,offset_12) EOP_C_AM2_IMM(A_COND_AL,1,0,1,rn,rd,offset_12)
 #define EOP_LDR_NEGIMM(rd,rn,offset_12) EOP_C_AM2_IMM(A_COND_AL,0,0,1,rn,rd,offset_12)
@@ -184,6 +186,7 @@
 #define EOP_LDR_REG_LSL(cond,rd,rn,rm,shift_imm) EOP_C_AM2_REG(cond,1,0,1,rn,rd,shift_imm,A_AM1_LSL,rm)
 
 #define EOP_LDRH_IMM2(cond,rd,rn,offset_8)  EOP_C_AM3_IMM(cond,1,1,rn,rd,0,1,offset_8)
+#define EOP_STRH_IMM2(cond,rd,rn,offset_8)  EOP_C_AM3_IMM(cond,1,0,rn,rd,0,1,offset_8)
 
 #define EOP_LDRH_IMM(   rd,rn,offset_8)  EOP_C_AM3_IMM(A_COND_AL,1,1,rn,rd,0,1,offset_8)
 #define EOP_LDRH_SIMPLE(rd,rn)           EOP_C_AM3_IMM(A_COND_AL,1,1,rn,rd,0,1,0)
@@ -590,6 +593,24 @@ static int emith_xbranch(int cond, void *target, int is_call)
 #define emith_read16_r_r_offs(r, rs, offs) \
 	emith_read16_r_r_offs_c(A_COND_AL, r, rs, offs)
 
+#define emith_write_r_r_offs_c(cond, r, rs, offs) \
+	EOP_STR_IMM2(cond, r, rs, offs)
+
+#define emith_write8_r_r_offs_c(cond, r, rs, offs) \
+	EOP_STRB_IMM2(cond, r, rs, offs)
+
+#define emith_write16_r_r_offs_c(cond, r, rs, offs) \
+	EOP_STRH_IMM2(cond, r, rs, offs)
+
+#define emith_write_r_r_offs(r, rs, offs) \
+	emith_write_r_r_offs_c(A_COND_AL, r, rs, offs)
+
+#define emith_write8_r_r_offs(r, rs, offs) \
+	emith_write8_r_r_offs_c(A_COND_AL, r, rs, offs)
+
+#define emith_write16_r_r_offs(r, rs, offs) \
+	emith_write16_r_r_offs_c(A_COND_AL, r, rs, offs)
+
 #define emith_ctx_read(r, offs) \
 	emith_read_r_r_offs(r, CONTEXT_REG, offs)
 
@@ -16,6 +16,8 @@ extern "C" {
 // PicoDrive hacks
 #define FAMEC_FETCHBITS 8
 #define M68K_FETCHBANK1 (1 << FAMEC_FETCHBITS)
+// bank size of the memory maps below, must match M68K_MEM_SHIFT
+#define FAMEC_MAP_SHIFT 16
 
 //#define M68K_RUNNING    0x01
 #define FM68K_HALTED     0x80
@@ -141,6 +143,13 @@ typedef struct
 	unsigned char  pad[3];
 
 	unsigned long  Fetch[M68K_FETCHBANK1];
+
+	// PD extension: memory maps in pico/memory.h format, accessed inline.
+	// entries are (membase >> 1) or ((handler >> 1) | msb)
+	const unsigned long *read8_map;
+	const unsigned long *read16_map;
+	const unsigned long *write8_map;
+	const unsigned long *write16_map;
 } M68K_CONTEXT;
 
 extern M68K_CONTEXT *g_m68kcontext;
@@ -33,6 +33,7 @@
 #define USE_CYCLONE_TIMING
 #define USE_CYCLONE_TIMING_DIV
 #define PICODRIVE_HACK
+#define FAMEC_DIRECT_MAPS
 // Options //
 
 #ifndef FAMEC_NO_GOTOS
@@ -459,6 +460,135 @@ typedef signed int	s32;
     D = (u16)m68kcontext.read_word(AREG(7));   \
     AREG(7) += 2;
 
+#ifdef FAMEC_DIRECT_MAPS
+// memory banks are accessed directly, handlers are only called for I/O.
+// same behavior as the MAKE_68K_* accessors in pico/memory.h
+#define MAP_FLAG_F ((uptr)1 << (sizeof(uptr) * 8 - 1))
+
+#undef READ_BYTE_F
+#define READ_BYTE_F(A, D)                                   \
+{                                                           \
+    u32 a_ = (A) & 0x00ffffff;                              \
+    uptr v_ = m68kcontext.read8_map[a_ >> FAMEC_MAP_SHIFT]; \
+    if (v_ & MAP_FLAG_F)                                    \
+        D = ((u32 (*)(u32))(v_ << 1))(a_) & 0xFF;           \
+    else                                                    \
+        D = *(u8 *)((v_ << 1) + (a_ ^ 1));                  \
+}
+
+#undef READSX_BYTE_F
+#define READSX_BYTE_F(A, D)                                 \
+{                                                           \
+    u32 a_ = (A) & 0x00ffffff;                              \
+    uptr v_ = m68kcontext.read8_map[a_ >> FAMEC_MAP_SHIFT]; \
+    if (v_ & MAP_FLAG_F)                                    \
+        D = (s8)((u32 (*)(u32))(v_ << 1))(a_);              \
+    else                                                    \
+        D = *(s8 *)((v_ << 1) + (a_ ^ 1));                  \
+}
+
+#undef READ_WORD_F
+#define READ_WORD_F(A, D)                                   \
+{                                                           \
+    u32 a_ = (A) & 0x00fffffe;                              \
+    uptr v_ = m68kcontext.read16_map[a_ >> FAMEC_MAP_SHIFT];\
+    if (v_ & MAP_FLAG_F)                                    \
+        D = ((u32 (*)(u32))(v_ << 1))(a_) & 0xFFFF;         \
+    else                                                    \
+        D = *(u16 *)((v_ << 1) + a_);                       \
+}
+
+#undef READSX_WORD_F
+#define READSX_WORD_F(A, D)                                 \
+{                                                           \
+    u32 a_ = (A) & 0x00fffffe;                              \
+    uptr v_ = m68kcontext.read16_map[a_ >> FAMEC_MAP_SHIFT];\
+    if (v_ & MAP_FLAG_F)                                    \
+        D = (s16)((u32 (*)(u32))(v_ << 1))(a_);             \
+    else                                                    \
+        D = *(s16 *)((v_ << 1) + a_);                       \
+}
+
+#undef READ_LONG_F
+#define READ_LONG_F(A, D)                                   \
+{                                                           \
+    u32 a_ = (A) & 0x00fffffe;                              \
+    uptr v_ = m68kcontext.read16_map[a_ >> FAMEC_MAP_SHIFT];\
+    if (v_ & MAP_FLAG_F)                                    \
+        D = m68kcontext.read_long(a_);                      \
+    else {                                                  \
+        u16 *m_ = (u16 *)((v_ << 1) + a_);                  \
+        D = (m_[0] << 16) | m_[1];                          \
+    }                                                       \
+}
+
+#undef READSX_LONG_F
+#define READSX_LONG_F READ_LONG_F
+
+#undef WRITE_BYTE_F
+#define WRITE_BYTE_F(A, D)                                  \
+{                                                           \
+    u32 a_ = (A) & 0x00ffffff;                              \
+    uptr v_ = m68kcontext.write8_map[a_ >> FAMEC_MAP_SHIFT];\
+    if (v_ & MAP_FLAG_F)                                    \
+        ((void (*)(u32, u32))(v_ << 1))(a_, (u8)(D));       \
+    else                                                    \
+        *(u8 *)((v_ << 1) + (a_ ^ 1)) = (D);                \
+}
+
+#undef WRITE_WORD_F
+#define WRITE_WORD_F(A, D)                                  \
+{                                                           \
+    u32 a_ = (A) & 0x00fffffe;                              \
+    uptr v_ = m68kcontext.write16_map[a_ >> FAMEC_MAP_SHIFT];\
+    if (v_ & MAP_FLAG_F)                                    \
+        ((void (*)(u32, u32))(v_ << 1))(a_, (u16)(D));      \
+    else                                                    \
+        *(u16 *)((v_ << 1) + a_) = (D);                     \
+}
+
+#undef WRITE_LONG_F
+#define WRITE_LONG_F(A, D)                                  \
+{                                                           \
+    u32 a_ = (A) & 0x00fffffe;                              \
+    uptr v_ = m68kcontext.write16_map[a_ >> FAMEC_MAP_SHIFT];\
+    if (v_ & MAP_FLAG_F)                                    \
+        m68kcontext.write_long(a_, D);                      \
+    else {                                                  \
+        u16 *m_ = (u16 *)((v_ << 1) + a_);                  \
+        u32 d_ = (D);                                       \
+        m_[0] = d_ >> 16;                                   \
+        m_[1] = d_;                                         \
+    }                                                       \
+}
+
+#undef WRITE_LONG_DEC_F
+#define WRITE_LONG_DEC_F(A, D)                              \
+    WRITE_WORD_F((A) + 2, (D) & 0xFFFF)                     \
+    WRITE_WORD_F((A), (D) >> 16)
+
+#undef PUSH_16_F
+#define PUSH_16_F(D)                                        \
+    AREG(7) -= 2;                                           \
+    WRITE_WORD_F(AREG(7), D)
+
+#undef POP_16_F
+#define POP_16_F(D)                                         \
+    READ_WORD_F(AREG(7), D)                                 \
+    D = (u16)D;                                             \
+    AREG(7) += 2;
+
+#undef PUSH_32_F
+#define PUSH_32_F(D)                                        \
+    AREG(7) -= 4;                                           \
+    WRITE_LONG_F(AREG(7), D)
+
+#undef POP_32_F
+#define POP_32_F(D)                                         \
+    READ_LONG_F(AREG(7), D)                                 \
+    AREG(7) += 4;
+#endif // FAMEC_DIRECT_MAPS
+
 #define GET_CCR                                     \
     (((flag_C >> (M68K_SR_C_SFT - 0)) & 1) |   \
      ((flag_V >> (M68K_SR_V_SFT - 1)) & 2) |   \
@@ -16,10 +16,11 @@
  * - remaining register caching and tracking in temporaries
  * - block-local branch linking
  * - block linking (except between tcaches)
- * - some constant propagation
+ * - constant and T propagation, also over block-local branches
+ * - inline SDRAM/data array access (other areas use memory handlers)
  *
  * TODO:
- * - better constant propagation
+ * - carry host reg allocation over block-local branches
  * - stack caching?
  * - bug fixing
  */
@@ -37,9 +38,14 @@
 // features
 #define PROPAGATE_CONSTANTS     1
 #define LINK_BRANCHES           1
+#ifndef PDB_NET
+#define INLINE_MEM_ACCESS       1 // SDRAM/data array, PDB_NET checksums all
+#else
+#define INLINE_MEM_ACCESS       0
+#endif
 
 // limits (per block)
-#define MAX_BLOCK_SIZE          (BLOCK_INSN_LIMIT * 6 * 6)
+#define MAX_BLOCK_SIZE          (BLOCK_INSN_LIMIT * 6 * 10)
 
 // max literal offset from the block end
 #define MAX_LITERAL_OFFSET      32*2
@@ -123,8 +129,68 @@ enum op_types {
   OP_MOVA,
   OP_SLEEP,
   OP_RTE,
+  OP_UNDEFINED, // illegal insn, raises an exception
 };
 
+// find local control flow successors of insn i (for delayed branches
+// the edges start at the delay slot). t is the known T state at the
+// branch insn (OF_T_SET, OF_T_CLEAR or 0), used to skip dead edges.
+// next/target are set to insn indices or -1.
+static void op_successors(int i, int i_end, unsigned int base_pc,
+  const unsigned char *op_flags, int t, int *next, int *target)
+{
+  struct op_data *opd_b = &ops[i];
+  int taken = 1, not_taken = 1;
+  int v;
+
+  *next = *target = -1;
+
+  if (op_flags[i + 1] & OF_DELAY_OP) {
+    // branch takes effect after the delay slot
+    *next = i + 1;
+    return;
+  }
+  if (op_flags[i] & OF_DELAY_OP)
+    opd_b = &ops[i - 1];
+
+  switch (opd_b->op) {
+  case OP_BRANCH_R:
+  case OP_BRANCH_RF:
+  case OP_RTE:
+    return;
+  case OP_BRANCH_CT:
+  case OP_BRANCH_CF:
+    if (t == OF_T_SET) {
+      if (opd_b->op == OP_BRANCH_CT)
+        not_taken = 0;
+      else
+        taken = 0;
+    }
+    else if (t == OF_T_CLEAR) {
+      if (opd_b->op == OP_BRANCH_CF)
+        not_taken = 0;
+      else
+        taken = 0;
+    }
+    break;
+  case OP_BRANCH:
+    not_taken = 0;
+    break;
+  default:
+    taken = 0;
+    break;
+  }
+
+  if (not_taken && i + 1 < i_end)
+    *next = i + 1;
+  if (taken && opd_b->imm >= base_pc && !(opd_b->imm & 1)) {
+    v = (opd_b->imm - base_pc) / 2;
+    if (v < i_end && (op_flags[v] & OF_BTARGET)
+        && !(op_flags[v] & OF_DELAY_OP))
+      *target = v;
+  }
+}
+
 #ifdef DRC_SH2
 
 static int literal_disabled_frames;
@@ -451,6 +517,7 @@ static void REGPARM(1) flush_tcache(int tcid)
   dbg(1, "tcache #%d flush! (%d/%d, bds %d/%d)", tcid,
     tcache_ptrs[tcid] - tcache_bases[tcid], tcache_sizes[tcid],
     block_counts[tcid], block_max_counts[tcid]);
+  pstat_add(PSTAT_SH2_FLUSHES, 1);
 
   block_counts[tcid] = 0;
   block_link_pool_counts[tcid] = 0;
@@ -685,6 +752,8 @@ static u32 dr_gcregs[24];
 // a mask of constant/dirty regs
 static u32 dr_gcregs_mask;
 static u32 dr_gcregs_dirty;
+// constants that are already written back to ctx
+static u32 dr_gcregs_ctx;
 
 #if PROPAGATE_CONSTANTS
 static void gconst_new(sh2_reg_e r, u32 val)
@@ -693,6 +762,7 @@ static void gconst_new(sh2_reg_e r, u32 val)
 
   dr_gcregs_mask  |= 1 << r;
   dr_gcregs_dirty |= 1 << r;
+  dr_gcregs_ctx   &= ~(1 << r);
   dr_gcregs[r] = val;
 
   // throw away old r that we might have cached
@@ -722,13 +792,14 @@ static int gconst_check(sh2_reg_e r)
   return 0;
 }
 
-// update hr if dirty, else do nothing
+// update hr if dirty, else do nothing.
+// returns 1 if hr needs to be written back
 static int gconst_try_read(int hr, sh2_reg_e r)
 {
   if (dr_gcregs_dirty & (1 << r)) {
     emith_move_r_imm(hr, dr_gcregs[r]);
     dr_gcregs_dirty &= ~(1 << r);
-    return 1;
+    return !(dr_gcregs_ctx & (1 << r));
   }
   return 0;
 }
@@ -744,6 +815,7 @@ static void gconst_kill(sh2_reg_e r)
 {
   dr_gcregs_mask &= ~(1 << r);
   dr_gcregs_dirty &= ~(1 << r);
+  dr_gcregs_ctx &= ~(1 << r);
 }
 
 static void gconst_clean(void)
@@ -751,7 +823,7 @@ static void gconst_clean(void)
   int i;
 
   for (i = 0; i < ARRAY_SIZE(dr_gcregs); i++)
-    if (dr_gcregs_dirty & (1 << i)) {
+    if (dr_gcregs_dirty & ~dr_gcregs_ctx & (1 << i)) {
       // using RC_GR_READ here: it will call gconst_try_read,
       // cache the reg and mark it dirty.
       rcache_get_reg_(i, RC_GR_READ, 0);
@@ -760,9 +832,29 @@ static void gconst_clean(void)
 
 static void gconst_invalidate(void)
 {
-  dr_gcregs_mask = dr_gcregs_dirty = 0;
+  dr_gcregs_mask = dr_gcregs_dirty = dr_gcregs_ctx = 0;
 }
 
+#if PROPAGATE_CONSTANTS
+// re-establish constants after the reg cache was invalidated.
+// values must already be in ctx, or in host regs for static regs.
+static void gconst_restore(u32 mask, const u32 *vals)
+{
+  int i;
+
+  for (i = 0; i < ARRAY_SIZE(dr_gcregs); i++) {
+    if (!(mask & (1 << i)))
+      continue;
+    dr_gcregs[i] = vals[i];
+    dr_gcregs_mask |= 1 << i;
+    if (reg_map_g2h[i] == -1) {
+      dr_gcregs_dirty |= 1 << i;
+      dr_gcregs_ctx   |= 1 << i;
+    }
+  }
+}
+#endif
+
 static u16 rcache_counter;
 
 static temp_reg_t *rcache_evict(void)
@@ -1106,17 +1198,83 @@ static void emit_or_t_if_eq(int srr)
   EMITH_SJMP_END(DCOND_NE);
 }
 
+// SDRAM and data array are accessed directly, everything else goes
+// through the memory handlers. On entry arg0 holds the address,
+// on exit arg0 holds the (unextended) value read.
+static void emit_memhandler_read_fast(int size)
+{
+  void *jmp_da, *jmp_slow, *jmp_acc, *jmp_done;
+  int arg0, tmp;
+  arg0 = rcache_get_tmp_arg(0); // don't let rcache_get_tmp() evict it
+
+  tmp = rcache_get_tmp();
+  // 0x06000000, 0x26000000 and mirrors
+  emith_and_r_r_imm(tmp, arg0, 0xde000000);
+  emith_cmp_r_imm(tmp, 0x06000000);
+  jmp_da = tcache_ptr;
+  emith_jump_cond_patchable(DCOND_NE, tcache_ptr);
+  emith_ctx_read(tmp, offsetof(SH2, p_sdram));
+  emith_clear_msb(arg0, arg0, 14);
+  jmp_acc = tcache_ptr;
+  emith_jump_patchable(tcache_ptr);
+
+  // 0xc0000000 and mirrors
+  emith_jump_patch(jmp_da, tcache_ptr);
+  emith_lsr(tmp, arg0, SH2_READ_SHIFT);
+  emith_cmp_r_imm(tmp, 0xc0000000 >> SH2_READ_SHIFT);
+  jmp_slow = tcache_ptr;
+  emith_jump_cond_patchable(DCOND_NE, tcache_ptr);
+  emith_ctx_read(tmp, offsetof(SH2, p_da));
+  emith_clear_msb(arg0, arg0, 20);
+
+  // both are stored as byteswapped 16bit words
+  emith_jump_patch(jmp_acc, tcache_ptr);
+  switch (size) {
+  case 0: // 8
+    emith_eor_r_imm(arg0, 1);
+    emith_add_r_r(arg0, tmp);
+    emith_read8_r_r_offs(arg0, arg0, 0);
+    break;
+  case 1: // 16
+    emith_bic_r_imm(arg0, 1);
+    emith_add_r_r(arg0, tmp);
+    emith_read16_r_r_offs(arg0, arg0, 0);
+    break;
+  case 2: // 32
+    emith_bic_r_imm(arg0, 3);
+    emith_add_r_r(arg0, tmp);
+    emith_read_r_r_offs(arg0, arg0, 0);
+    emith_ror(arg0, arg0, 16);
+    break;
+  }
+  rcache_free_tmp(tmp);
+  jmp_done = tcache_ptr;
+  emith_jump_patchable(tcache_ptr);
+
+  emith_jump_patch(jmp_slow, tcache_ptr);
+  switch (size) {
+  case 0: // 8
+    emith_call(sh2_drc_read8);
+    break;
+  case 1: // 16
+    emith_call(sh2_drc_read16);
+    break;
+  case 2: // 32
+    emith_call(sh2_drc_read32);
+    break;
+  }
+  emith_jump_patch(jmp_done, tcache_ptr);
+}
+
 // arguments must be ready
 // reg cache must be clean before call
 static int emit_memhandler_read_(int size, int ram_check)
 {
+  u32 gcmask;
   int arg1;
-#if 0
-  int arg0;
-  host_arg2reg(arg0, 0);
-#endif
 
   rcache_clean();
+  gcmask = dr_gcregs_mask & ~BITMASK1(SHR_SR);
 
   // must writeback cycles for poll detection stuff
   // FIXME: rm
@@ -1126,41 +1284,9 @@ static int emit_memhandler_read_(int size, int ram_check)
   arg1 = rcache_get_tmp_arg(1);
   emith_move_r_r(arg1, CONTEXT_REG);
 
-#if 0 // can't do this because of unmapped reads
- // ndef PDB_NET
-  if (ram_check && Pico.rom == (void *)0x02000000 && Pico32xMem->sdram == (void *)0x06000000) {
-    int tmp = rcache_get_tmp();
-    emith_and_r_r_imm(tmp, arg0, 0xfb000000);
-    emith_cmp_r_imm(tmp, 0x02000000);
-    switch (size) {
-    case 0: // 8
-      EMITH_SJMP3_START(DCOND_NE);
-      emith_eor_r_imm_c(DCOND_EQ, arg0, 1);
-      emith_read8_r_r_offs_c(DCOND_EQ, arg0, arg0, 0);
-      EMITH_SJMP3_MID(DCOND_NE);
-      emith_call_cond(DCOND_NE, sh2_drc_read8);
-      EMITH_SJMP3_END();
-      break;
-    case 1: // 16
-      EMITH_SJMP3_START(DCOND_NE);
-      emith_read16_r_r_offs_c(DCOND_EQ, arg0, arg0, 0);
-      EMITH_SJMP3_MID(DCOND_NE);
-      emith_call_cond(DCOND_NE, sh2_drc_read16);
-      EMITH_SJMP3_END();
-      break;
-    case 2: // 32
-      EMITH_SJMP3_START(DCOND_NE);
-      emith_read_r_r_offs_c(DCOND_EQ, arg0, arg0, 0);
-      emith_ror_c(DCOND_EQ, arg0, arg0, 16);
-      EMITH_SJMP3_MID(DCOND_NE);
-      emith_call_cond(DCOND_NE, sh2_drc_read32);
-      EMITH_SJMP3_END();
-      break;
-    }
-  }
-  else
-#endif
-  {
+  if (ram_check && INLINE_MEM_ACCESS)
+    emit_memhandler_read_fast(size);
+  else {
     switch (size) {
     case 0: // 8
       emith_call(sh2_drc_read8);
@@ -1174,6 +1300,10 @@ static int emit_memhandler_read_(int size, int ram_check)
     }
   }
   rcache_invalidate();
+#if PROPAGATE_CONSTANTS
+  // handlers don't touch guest regs (except SR cycles)
+  gconst_restore(gcmask, dr_gcregs);
+#endif
 
   if (reg_map_g2h[SHR_SR] != -1)
     emith_ctx_read(reg_map_g2h[SHR_SR], SHR_SR * 4);
@@ -1231,18 +1361,68 @@ static int emit_memhandler_read_rr(sh2_reg_e rd, sh2_reg_e rs, u32 offs, int siz
   return hr2;
 }
 
-static void emit_memhandler_write(int size)
+static void emit_memhandler_write_(int size, int fast)
 {
-  int ctxr;
+  void *jmp_slow[2], *jmp_done;
+  u32 gcmask;
+  int arg0, arg1, ctxr;
   host_arg2reg(ctxr, 2);
   if (reg_map_g2h[SHR_SR] != -1)
     emith_ctx_write(reg_map_g2h[SHR_SR], SHR_SR * 4);
 
   rcache_clean();
+  gcmask = dr_gcregs_mask & ~BITMASK1(SHR_SR);
+
+  jmp_done = NULL;
+  if (fast && INLINE_MEM_ACCESS) {
+    // direct SDRAM store, unless there is code translated from
+    // the written word; 8bit 0x26 writes need the sync hack
+    int tmp, tmp2;
+    arg0 = rcache_get_tmp_arg(0);
+    arg1 = rcache_get_tmp_arg(1);
+    tmp = rcache_get_tmp();
+    tmp2 = rcache_get_tmp();
+    emith_and_r_r_imm(tmp, arg0, size == 0 ? 0xfe000000 : 0xde000000);
+    emith_cmp_r_imm(tmp, 0x06000000);
+    jmp_slow[0] = tcache_ptr;
+    emith_jump_cond_patchable(DCOND_NE, tcache_ptr);
+    emith_ctx_read(tmp, offsetof(SH2, p_sdram));
+    emith_clear_msb(tmp2, arg0, 14);
+    if (size == 0)
+      emith_eor_r_imm(tmp2, 1);
+    else
+      emith_bic_r_imm(tmp2, size == 1 ? 1 : 3);
+    emith_add_r_r(tmp, tmp2);
+    // drcblk_ram follows sdram, checks both words of a long
+    emith_add_r_r_imm(tmp2, tmp, offsetof(struct Pico32xMem, drcblk_ram)
+      - offsetof(struct Pico32xMem, sdram));
+    emith_bic_r_imm(tmp2, 3);
+    emith_read_r_r_offs(tmp2, tmp2, 0);
+    emith_tst_r_r(tmp2, tmp2);
+    jmp_slow[1] = tcache_ptr;
+    emith_jump_cond_patchable(DCOND_NE, tcache_ptr);
+    switch (size) {
+    case 0: // 8
+      emith_write8_r_r_offs(arg1, tmp, 0);
+      break;
+    case 1: // 16
+      emith_write16_r_r_offs(arg1, tmp, 0);
+      break;
+    case 2: // 32
+      emith_ror(arg1, arg1, 16);
+      emith_write_r_r_offs(arg1, tmp, 0);
+      break;
+    }
+    rcache_free_tmp(tmp2);
+    rcache_free_tmp(tmp);
+    jmp_done = tcache_ptr;
+    emith_jump_patchable(tcache_ptr);
+    emith_jump_patch(jmp_slow[0], tcache_ptr);
+    emith_jump_patch(jmp_slow[1], tcache_ptr);
+  }
 
   switch (size) {
   case 0: // 8
-    // XXX: consider inlining sh2_drc_write8
     emith_call(sh2_drc_write8);
     break;
   case 1: // 16
@@ -1253,12 +1433,22 @@ static void emit_memhandler_write(int size)
     emith_call(sh2_drc_write32);
     break;
   }
+  if (jmp_done != NULL)
+    emith_jump_patch(jmp_done, tcache_ptr);
 
   rcache_invalidate();
+#if PROPAGATE_CONSTANTS
+  gconst_restore(gcmask, dr_gcregs);
+#endif
   if (reg_map_g2h[SHR_SR] != -1)
     emith_ctx_read(reg_map_g2h[SHR_SR], SHR_SR * 4);
 }
 
+static void emit_memhandler_write(int size)
+{
+  emit_memhandler_write_(size, 1);
+}
+
 // @(Rx,Ry)
 static int emit_indirect_indexed_read(int rx, int ry, int size)
 {
@@ -1360,6 +1550,116 @@ static void emit_block_entry(void)
 
 static void *dr_get_pc_base(u32 pc, int is_slave);
 
+#if PROPAGATE_CONSTANTS
+// R0-R15 constants known on entry to each insn
+static u32 op_gconst_mask[BLOCK_INSN_LIMIT];
+static u32 op_gconst_val[BLOCK_INSN_LIMIT][16];
+
+static void gconst_meet(int i, u32 mask, const u32 *val, u8 *seen,
+  int *changed)
+{
+  int r;
+
+  if (!seen[i]) {
+    seen[i] = 1;
+    op_gconst_mask[i] = mask;
+    memcpy(op_gconst_val[i], val, sizeof(op_gconst_val[0]));
+    *changed = 1;
+    return;
+  }
+
+  mask &= op_gconst_mask[i];
+  for (r = 0; r < 16; r++)
+    if ((mask & (1 << r)) && op_gconst_val[i][r] != val[r])
+      mask &= ~(1 << r);
+  if (mask != op_gconst_mask[i]) {
+    op_gconst_mask[i] = mask;
+    *changed = 1;
+  }
+}
+
+// dataflow pass over ops[] finding constants that reach branch targets
+// on all local paths. Literal pool loads count only if they lie inside
+// the block, their addresses are added to literal_addr for SMC checks.
+static void dr_scan_gconsts(u32 base_pc, u16 *dr_pc_base, const u8 *op_flags,
+  int i_end, u32 end_literals, u32 *literal_addr, int *literal_addr_count)
+{
+  u8 seen[BLOCK_INSN_LIMIT];
+  struct op_data *opd;
+  u32 mask, val[16];
+  int i, r, t, changed;
+  int next, target;
+  u32 op;
+
+  memset(seen, 0, sizeof(seen));
+  memset(op_gconst_mask, 0, sizeof(op_gconst_mask));
+  seen[0] = 1; // nothing known at block entry
+
+  do {
+    changed = 0;
+    for (i = 0; i < i_end; i++) {
+      if (!seen[i])
+        continue;
+
+      opd = &ops[i];
+      op = FETCH_OP(base_pc + i * 2);
+      mask = op_gconst_mask[i];
+      memcpy(val, op_gconst_val[i], sizeof(val));
+
+      r = GET_Rn();
+      if ((op & 0xf000) == 0xe000) {
+        // MOV #imm,Rn
+        mask |= 1 << r;
+        val[r] = opd->imm;
+      }
+      else if ((op & 0xf000) == 0x7000) {
+        // ADD #imm,Rn
+        val[r] += opd->imm;
+      }
+      else if ((op & 0xf00f) == 0x6003) {
+        // MOV Rm,Rn
+        if (mask & (1 << GET_Rm())) {
+          mask |= 1 << r;
+          val[r] = val[GET_Rm()];
+        }
+        else
+          mask &= ~(1 << r);
+      }
+      else if (opd->op == OP_MOVA && opd->imm != 0) {
+        mask |= 1 << SHR_R0;
+        val[SHR_R0] = opd->imm;
+      }
+      else if (opd->op == OP_LOAD_POOL && opd->imm != 0
+               && opd->imm < end_literals
+               && (find_in_array(literal_addr, *literal_addr_count,
+                                 opd->imm) >= 0
+                   || *literal_addr_count < MAX_LITERALS))
+      {
+        if (find_in_array(literal_addr, *literal_addr_count, opd->imm) < 0)
+          literal_addr[(*literal_addr_count)++] = opd->imm;
+        mask |= 1 << r;
+        if (opd->size == 2)
+          val[r] = FETCH32(opd->imm);
+        else
+          val[r] = (u32)(int)(signed short)FETCH_OP(opd->imm);
+      }
+      else if (opd->op == OP_UNDEFINED)
+        mask = 0;
+      else
+        mask &= ~opd->dest;
+
+      t = (op_flags[i] & OF_DELAY_OP) ? op_flags[i - 1] : op_flags[i];
+      op_successors(i, i_end, base_pc, op_flags, t & (OF_T_SET | OF_T_CLEAR),
+        &next, &target);
+      if (next >= 0)
+        gconst_meet(next, mask, val, seen, &changed);
+      if (target >= 0)
+        gconst_meet(target, mask, val, seen, &changed);
+    }
+  } while (changed);
+}
+#endif
+
 static void REGPARM(2) *sh2_translate(SH2 *sh2, int tcache_id)
 {
   u32 branch_target_pc[MAX_LOCAL_BRANCHES];
@@ -1411,6 +1711,7 @@ static void REGPARM(2) *sh2_translate(SH2 *sh2, int tcache_id)
     dbg(1, "tcache %d overflow", tcache_id);
     return NULL;
   }
+  pstat_add(PSTAT_SH2_BLOCKS, 1);
 
   // initial passes to disassemble and analyze the block
   scan_block(base_pc, sh2->is_slave, op_flags, &end_pc, &end_literals);
@@ -1444,6 +1745,11 @@ static void REGPARM(2) *sh2_translate(SH2 *sh2, int tcache_id)
     memset(branch_target_ptr, 0, sizeof(branch_target_ptr[0]) * branch_target_count);
   }
 
+#if PROPAGATE_CONSTANTS
+  dr_scan_gconsts(base_pc, dr_pc_base, op_flags, (end_pc - base_pc) / 2,
+    end_literals, literal_addr, &literal_addr_count);
+#endif
+
   // clear stale state after compile errors
   rcache_invalidate();
 
@@ -1476,9 +1782,18 @@ static void REGPARM(2) *sh2_translate(SH2 *sh2, int tcache_id)
         FLUSH_CYCLES(sr);
         rcache_flush();
 
-        // make block entry
+        // make block entry, unless state is carried over from local
+        // branches - outside callers can't guarantee it
+        tmp = op_flags[i] & (OF_T_SET | OF_T_CLEAR);
+#if PROPAGATE_CONSTANTS
+        tmp |= op_gconst_mask[i];
+#endif
         v = block->entry_count;
-        if (v < ARRAY_SIZE(block->entryp)) {
+        if (tmp) {
+          dbg(2, "-- %csh2 block #%d,%d no entry at %08x, state carried",
+            sh2->is_slave ? 's' : 'm', tcache_id, blkid_main, pc);
+        }
+        else if (v < ARRAY_SIZE(block->entryp)) {
           block->entryp[v].pc = pc;
           block->entryp[v].tcache_ptr = tcache_ptr;
           block->entryp[v].links = NULL;
@@ -1518,6 +1833,11 @@ static void REGPARM(2) *sh2_translate(SH2 *sh2, int tcache_id)
       emith_jump_cond(DCOND_LE, sh2_drc_exit);
       do_host_disasm(tcache_id);
       rcache_unlock_all();
+
+#if PROPAGATE_CONSTANTS
+      // all paths here have flushed these same values to ctx
+      gconst_restore(op_gconst_mask[i], op_gconst_val[i]);
+#endif
     }
 
 #ifdef DRC_CMP
@@ -1586,9 +1906,14 @@ static void REGPARM(2) *sh2_translate(SH2 *sh2, int tcache_id)
 
     switch (opd->op)
     {
-    case OP_BRANCH:
     case OP_BRANCH_CT:
     case OP_BRANCH_CF:
+      if ((opd->op == OP_BRANCH_CT && (op_flags[i] & OF_T_CLEAR))
+          || (opd->op == OP_BRANCH_CF && (op_flags[i] & OF_T_SET)))
+        // never taken
+        goto end_op;
+      // fallthrough
+    case OP_BRANCH:
       if (opd->dest & BITMASK1(SHR_PR))
         emit_move_r_imm32(SHR_PR, pc + 2);
       drcf.pending_branch_direct = 1;
@@ -1639,9 +1964,12 @@ static void REGPARM(2) *sh2_translate(SH2 *sh2, int tcache_id)
     case OP_LOAD_POOL:
 #if PROPAGATE_CONSTANTS
       if (opd->imm != 0 && opd->imm < end_literals
-          && literal_addr_count < MAX_LITERALS)
+          && (find_in_array(literal_addr, literal_addr_count, opd->imm) >= 0
+              || literal_addr_count < MAX_LITERALS))
       {
-        ADD_TO_ARRAY(literal_addr, literal_addr_count, opd->imm,);
+        if (find_in_array(literal_addr, literal_addr_count, opd->imm) < 0) {
+          ADD_TO_ARRAY(literal_addr, literal_addr_count, opd->imm,);
+        }
         if (opd->size == 2)
           tmp = FETCH32(opd->imm);
         else
@@ -1734,10 +2062,14 @@ static void REGPARM(2) *sh2_translate(SH2 *sh2, int tcache_id)
         switch (GET_Fx())
         {
         case 0: // CLRT               0000000000001000
+          if (op_flags[i] & OF_T_CLEAR)
+            break;
           sr = rcache_get_reg(SHR_SR, RC_GR_RMW);
           emith_bic_r_imm(sr, T);
           break;
         case 1: // SETT               0000000000011000
+          if (op_flags[i] & OF_T_SET)
+            break;
           sr = rcache_get_reg(SHR_SR, RC_GR_RMW);
           emith_or_r_imm(sr, T);
           break;
@@ -2396,6 +2728,13 @@ static void REGPARM(2) *sh2_translate(SH2 *sh2, int tcache_id)
         goto end_op;
       case 0x03:
       case 0x07 ... 0x0f:
+#if PROPAGATE_CONSTANTS
+        if ((op & 0x0f) == 0x03 && gconst_get(GET_Rm(), &tmp)) {
+          // MOV    Rm,Rn  with Rm known
+          emit_move_r_imm32(GET_Rn(), tmp);
+          goto end_op;
+        }
+#endif
         tmp  = rcache_get_reg(GET_Rm(), RC_GR_READ);
         tmp2 = rcache_get_reg(GET_Rn(), RC_GR_WRITE);
         switch (op & 0x0f)
@@ -2452,6 +2791,12 @@ static void REGPARM(2) *sh2_translate(SH2 *sh2, int tcache_id)
     /////////////////////////////////////////////
     case 0x07:
       // ADD #imm,Rn  0111nnnniiiiiiii
+#if PROPAGATE_CONSTANTS
+      if (gconst_get(GET_Rn(), &tmp)) {
+        emit_move_r_imm32(GET_Rn(), tmp + (u32)(int)(signed char)op);
+        goto end_op;
+      }
+#endif
       tmp = rcache_get_reg(GET_Rn(), RC_GR_RMW);
       if (op & 0x80) { // adding negative
         emith_sub_r_imm(tmp, -op & 0xff);
@@ -3328,9 +3673,11 @@ void scan_block(u32 base_pc, int is_slave, u8 *op_flags, u32 *end_pc_out,
   u32 end_pc, end_literals = 0;
   u32 lowest_mova = 0;
   struct op_data *opd;
+  u8 t_state[BLOCK_INSN_LIMIT];
   int next_is_delay = 0;
   int end_block = 0;
-  int i, i_end;
+  int i, i_end, t, v;
+  int changed;
 
   memset(op_flags, 0, BLOCK_INSN_LIMIT);
 
@@ -4058,6 +4405,7 @@ void scan_block(u32 base_pc, int is_slave, u8 *op_flags, u32 *end_pc_out,
 
     default:
     undefined:
+      opd->op = OP_UNDEFINED;
       elprintf(EL_ANOMALY, "%csh2 drc: unhandled op %04x @ %08x",
         is_slave ? 's' : 'm', op, pc);
       break;
@@ -4066,20 +4414,65 @@ void scan_block(u32 base_pc, int is_slave, u8 *op_flags, u32 *end_pc_out,
   i_end = i;
   end_pc = pc;
 
-  // 2nd pass: some analysis
-  for (i = 0; i < i_end; i++) {
-    opd = &ops[i];
+  // 2nd pass: propagate T over the block, including local branches.
+  // t_state is a set of values T may have (OF_T_SET | OF_T_CLEAR), edges
+  // that can't be taken don't contribute.
+  memset(t_state, 0, sizeof(t_state));
+  t_state[0] = OF_T_SET | OF_T_CLEAR; // unknown at block entry
+  do {
+    changed = 0;
+    for (i = 0; i < i_end; i++) {
+      int next, target, t_next, t_target, t_br;
+
+      if (t_state[i] == 0) // not reached (yet)
+        continue;
+
+      opd = &ops[i];
+      t = t_state[i];
+      if (opd->op == OP_SETCLRT)
+        t = opd->imm ? OF_T_SET : OF_T_CLEAR;
+      else if (FETCH_OP(base_pc + i * 2) == 0x0019) // DIV0U
+        t = OF_T_CLEAR;
+      else if (opd->dest & BITMASK1(SHR_T))
+        t = OF_T_SET | OF_T_CLEAR;
+
+      v = (op_flags[i] & OF_DELAY_OP) ? i - 1 : i;
+      t_br = t_state[v];
+      if (t_br != OF_T_SET && t_br != OF_T_CLEAR)
+        t_br = 0;
+      op_successors(i, i_end, base_pc, op_flags, t_br, &next, &target);
+
+      t_next = t_target = t;
+      if (next != i + 1 || !(op_flags[next] & OF_DELAY_OP)) {
+        // T is known after a conditional branch, unless the slot set it
+        if ((ops[v].op == OP_BRANCH_CT || ops[v].op == OP_BRANCH_CF)
+            && (v == i || !(opd->dest & BITMASK1(SHR_T))))
+        {
+          t_target = ops[v].op == OP_BRANCH_CT ? OF_T_SET : OF_T_CLEAR;
+          t_next = t_target ^ (OF_T_SET | OF_T_CLEAR);
+        }
+      }
 
-    // propagate T (TODO: DIV0U)
-    if ((opd->op == OP_SETCLRT && !opd->imm) || opd->op == OP_BRANCH_CT)
-      op_flags[i + 1] |= OF_T_CLEAR;
-    else if ((opd->op == OP_SETCLRT && opd->imm) || opd->op == OP_BRANCH_CF)
-      op_flags[i + 1] |= OF_T_SET;
+      if (next >= 0 && (t_state[next] | t_next) != t_state[next]) {
+        t_state[next] |= t_next;
+        changed = 1;
+      }
+      if (target >= 0 && (t_state[target] | t_target) != t_state[target]) {
+        t_state[target] |= t_target;
+        changed = 1;
+      }
+    }
+  } while (changed);
 
-    if ((op_flags[i] & OF_BTARGET) || (opd->dest & BITMASK1(SHR_T)))
-      op_flags[i] &= ~(OF_T_SET | OF_T_CLEAR);
-    else
-      op_flags[i + 1] |= op_flags[i] & (OF_T_SET | OF_T_CLEAR);
+  for (i = 0; i < i_end; i++) {
+    op_flags[i] &= ~(OF_T_SET | OF_T_CLEAR);
+    if (t_state[i] == OF_T_SET || t_state[i] == OF_T_CLEAR)
+      op_flags[i] |= t_state[i];
+  }
+
+  // 3rd pass: branch folding, literals
+  for (i = 0; i < i_end; i++) {
+    opd = &ops[i];
 
     if ((opd->op == OP_BRANCH_CT && (op_flags[i] & OF_T_SET))
         || (opd->op == OP_BRANCH_CF && (op_flags[i] & OF_T_CLEAR)))
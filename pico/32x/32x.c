@@ -288,16 +288,17 @@ static void hint_event(unsigned int now)
   p32x_schedule_hint(NULL, now);
 }
 
-typedef void (event_cb)(unsigned int now);
-
 /* times are in m68k (7.6MHz) cycles */
 unsigned int p32x_event_times[P32X_EVENT_COUNT];
-static unsigned int event_time_next;
-static event_cb *p32x_event_cbs[P32X_EVENT_COUNT] = {
+static pico_event_cb * const p32x_event_cbs[P32X_EVENT_COUNT] = {
   p32x_pwm_irq_event,
   fillend_event,
   hint_event,
 };
+static struct pico_events p32x_events = {
+  p32x_event_times, p32x_event_cbs, P32X_EVENT_COUNT, "32x", EL_32X
+};
+PICO_EVENTS_CHECK(p32x, P32X_EVENT_COUNT);
 
 // schedule event at some time 'after', in m68k clocks
 void p32x_event_schedule(unsigned int now, enum p32x_event event, int after)
@@ -307,10 +308,7 @@ void p32x_event_schedule(unsigned int now, enum p32x_event event, int after)
   when = (now + after) | 1;
 
   elprintf(EL_32X, "32x: new event #%u %u->%u", event, now, when);
-  p32x_event_times[event] = when;
-
-  if (event_time_next == 0 || CYCLES_GT(event_time_next, when))
-    event_time_next = when;
+  pico_events_schedule(&p32x_events, event, when);
 }
 
 void p32x_event_schedule_sh2(SH2 *sh2, enum p32x_event event, int after)
@@ -320,49 +318,10 @@ void p32x_event_schedule_sh2(SH2 *sh2, enum p32x_event event, int after)
 
   p32x_event_schedule(now, event, after);
 
-  left_to_next = (event_time_next - now) * 3;
+  left_to_next = (p32x_events.next - now) * 3;
   sh2_end_run(sh2, left_to_next);
 }
 
-static void p32x_run_events(unsigned int until)
-{
-  int oldest, oldest_diff, time;
-  int i, diff;
-
-  while (1) {
-    oldest = -1, oldest_diff = 0x7fffffff;
-
-    for (i = 0; i < P32X_EVENT_COUNT; i++) {
-      if (p32x_event_times[i]) {
-        diff = p32x_event_times[i] - until;
-        if (diff < oldest_diff) {
-          oldest_diff = diff;
-          oldest = i;
-        }
-      }
-    }
-
-    if (oldest_diff <= 0) {
-      time = p32x_event_times[oldest];
-      p32x_event_times[oldest] = 0;
-      elprintf(EL_32X, "32x: run event #%d %u", oldest, time);
-      p32x_event_cbs[oldest](time);
-    }
-    else if (oldest_diff < 0x7fffffff) {
-      event_time_next = p32x_event_times[oldest];
-      break;
-    }
-    else {
-      event_time_next = 0;
-      break;
-    }
-  }
-
-  if (oldest != -1)
-    elprintf(EL_32X, "32x: next event #%d at %u",
-      oldest, event_time_next);
-}
-
 static INLINE void run_sh2(SH2 *sh2, int m68k_cycles)
 {
   int cycles, done;
@@ -374,6 +333,7 @@ static INLINE void run_sh2(SH2 *sh2, int m68k_cycles)
     sh2->m68krcycles_done, cycles, sh2->pc);
 
   done = sh2_execute(sh2, cycles, PicoOpt & POPT_EN_DRC);
+  pstat_add(PSTAT_MSH2_CYCLES + sh2->is_slave, done);
 
   sh2->m68krcycles_done += C_SH2_TO_M68K(*sh2, done);
   sh2->state &= ~SH2_STATE_RUN;
@@ -408,8 +368,8 @@ void p32x_sync_other_sh2(SH2 *sh2, unsigned int m68k_target)
   run_sh2(osh2, m68k_cycles);
 
   // there might be new event to schedule current sh2 to
-  if (event_time_next) {
-    left_to_event = event_time_next - m68k_target;
+  if (p32x_events.next) {
+    left_to_event = p32x_events.next - m68k_target;
     left_to_event *= 3;
     if (sh2_cycles_left(sh2) > left_to_event) {
       if (left_to_event < 1)
@@ -442,12 +402,12 @@ void sync_sh2s_normal(unsigned int m68k_target)
 
   while (CYCLES_GT(m68k_target, now))
   {
-    if (event_time_next && CYCLES_GE(now, event_time_next))
-      p32x_run_events(now);
+    if (p32x_events.next && CYCLES_GE(now, p32x_events.next))
+      pico_events_run(&p32x_events, now);
 
     target = m68k_target;
-    if (event_time_next && CYCLES_GT(target, event_time_next))
-      target = event_time_next;
+    if (p32x_events.next && CYCLES_GT(target, p32x_events.next))
+      target = p32x_events.next;
 
     while (CYCLES_GT(target, now))
     {
@@ -460,8 +420,8 @@ void sync_sh2s_normal(unsigned int m68k_target)
         if (cycles > 0) {
           run_sh2(&ssh2, cycles);
 
-          if (event_time_next && CYCLES_GT(target, event_time_next))
-            target = event_time_next;
+          if (p32x_events.next && CYCLES_GT(target, p32x_events.next))
+            target = p32x_events.next;
         }
       }
 
@@ -470,8 +430,8 @@ void sync_sh2s_normal(unsigned int m68k_target)
         if (cycles > 0) {
           run_sh2(&msh2, cycles);
 
-          if (event_time_next && CYCLES_GT(target, event_time_next))
-            target = event_time_next;
+          if (p32x_events.next && CYCLES_GT(target, p32x_events.next))
+            target = p32x_events.next;
         }
       }
 
@@ -584,7 +544,8 @@ void Pico32xStateLoaded(int is_early)
   sh2s[0].m68krcycles_done = sh2s[1].m68krcycles_done = SekCyclesDone();
   p32x_update_irls(NULL, SekCyclesDone());
   p32x_pwm_state_loaded();
-  p32x_run_events(SekCyclesDone());
+  pico_events_rebuild(&p32x_events);
+  pico_events_run(&p32x_events, SekCyclesDone());
 }
 
 // vim:shiftwidth=2:ts=2:expandtab
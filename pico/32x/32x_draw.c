@@ -82,6 +82,142 @@ static void convert_pal555(int invert_prio)
   }                                                               \
 }
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+
+// 8 pixels at a time; the MD layer below is either left in place or
+// taken from palmd (when not NULL), 32X pixel wins where 'show' is set
+static inline __m128i md_bg_mask8(const unsigned char *pmd, __m128i vmdbg)
+{
+  __m128i m = _mm_loadl_epi64((const void *)pmd);
+  m = _mm_cmpeq_epi8(_mm_and_si128(m, _mm_set1_epi8(0x3f)), vmdbg);
+  return _mm_unpacklo_epi8(m, m);
+}
+
+static inline void merge8(unsigned short *pd, const unsigned char *pmd,
+  __m128i px, __m128i show, const unsigned short *palmd)
+{
+  __m128i under;
+
+  if (_mm_movemask_epi8(show) == 0xffff) {
+    _mm_storeu_si128((void *)pd, px);
+    return;
+  }
+  if (palmd != NULL)
+    under = _mm_set_epi16(palmd[pmd[7]], palmd[pmd[6]], palmd[pmd[5]],
+      palmd[pmd[4]], palmd[pmd[3]], palmd[pmd[2]], palmd[pmd[1]],
+      palmd[pmd[0]]);
+  else
+    under = _mm_loadu_si128((void *)pd);
+  px = _mm_or_si128(_mm_and_si128(show, px), _mm_andnot_si128(show, under));
+  _mm_storeu_si128((void *)pd, px);
+}
+
+// palette entries carry prio in bit 5 (see convert_pal555)
+static inline void merge8_pal(unsigned short *pd, const unsigned char *pmd,
+  __m128i px, __m128i vmdbg, const unsigned short *palmd)
+{
+  __m128i show = _mm_srai_epi16(_mm_slli_epi16(px, 10), 15);
+  show = _mm_or_si128(show, md_bg_mask8(pmd, vmdbg));
+  merge8(pd, pmd, px, show, palmd);
+}
+
+static void do_line_dc_sse2(unsigned short *pd, const unsigned short *p32x,
+  const unsigned char *pmd, int inv, int mdbg, const unsigned short *palmd)
+{
+  const __m128i m1 = _mm_set1_epi16(0x001f);
+  const __m128i m2 = _mm_set1_epi16(0x03e0);
+  const __m128i m3 = _mm_set1_epi16(0x7c00);
+  const __m128i vinv = _mm_set1_epi16((short)inv);
+  const __m128i vmdbg = _mm_set1_epi8(mdbg);
+  __m128i t, px, show;
+  int i;
+
+  for (i = 0; i < 320; i += 8) {
+    t = _mm_loadu_si128((const void *)(p32x + i));
+    px = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(t, m1), 11),
+                      _mm_slli_epi16(_mm_and_si128(t, m2), 1));
+    px = _mm_or_si128(px, _mm_srli_epi16(_mm_and_si128(t, m3), 10));
+    show = _mm_srai_epi16(_mm_xor_si128(t, vinv), 15);
+    show = _mm_or_si128(show, md_bg_mask8(pmd + i, vmdbg));
+    merge8(pd + i, pmd + i, px, show, palmd);
+  }
+}
+
+static void do_line_pp_sse2(unsigned short *pd, const unsigned char *p32x,
+  const unsigned char *pmd, const unsigned short *pal, int mdbg,
+  const unsigned short *palmd)
+{
+  const __m128i vmdbg = _mm_set1_epi8(mdbg);
+  __m128i px;
+  int i;
+
+#define PP_PX(n) pal[*(unsigned char *)((long)(p32x + i + n) ^ 1)]
+  for (i = 0; i < 320; i += 8) {
+    px = _mm_set_epi16(PP_PX(7), PP_PX(6), PP_PX(5), PP_PX(4),
+                       PP_PX(3), PP_PX(2), PP_PX(1), PP_PX(0));
+    merge8_pal(pd + i, pmd + i, px, vmdbg, palmd);
+  }
+#undef PP_PX
+}
+
+static void do_line_rl_sse2(unsigned short *pd, const unsigned short *p32x,
+  const unsigned char *pmd, const unsigned short *pal, int mdbg,
+  const unsigned short *palmd)
+{
+  const __m128i vmdbg = _mm_set1_epi8(mdbg);
+  unsigned short line[320];
+  unsigned short t;
+  int i, len;
+
+  // expand the runs first, then merge like packed pixel
+  for (i = 0; i < 320; p32x++) {
+    t = pal[*p32x & 0xff];
+    len = (*p32x >> 8) + 1;
+    if (len > 320 - i)
+      len = 320 - i;
+    while (len-- > 0)
+      line[i++] = t;
+  }
+
+  for (i = 0; i < 320; i += 8)
+    merge8_pal(pd + i, pmd + i,
+      _mm_loadu_si128((void *)(line + i)), vmdbg, palmd);
+}
+
+// pmd_draw_code only selects the MD palette here, see MD_LAYER_CODE
+#undef do_line_dc
+#define do_line_dc(pd, p32x, pmd, inv, pmd_draw_code)             \
+{                                                                 \
+  const unsigned short *md_pal = NULL;                            \
+  pmd_draw_code;                                                  \
+  do_line_dc_sse2(pd, p32x, pmd, inv, mdbg, md_pal);              \
+  pd += 320; pmd += 320;                                          \
+}
+
+#undef do_line_pp
+#define do_line_pp(pd, p32x, pmd, pmd_draw_code)                  \
+{                                                                 \
+  const unsigned short *md_pal = NULL;                            \
+  pmd_draw_code;                                                  \
+  do_line_pp_sse2(pd, p32x, pmd, pal, mdbg, md_pal);              \
+  pd += 320; pmd += 320;                                          \
+}
+
+#undef do_line_rl
+#define do_line_rl(pd, p32x, pmd, pmd_draw_code)                  \
+{                                                                 \
+  const unsigned short *md_pal = NULL;                            \
+  pmd_draw_code;                                                  \
+  do_line_rl_sse2(pd, p32x, pmd, pal, mdbg, md_pal);              \
+  pd += 320; pmd += 320;                                          \
+}
+
+#define MD_LAYER_CODE \
+  md_pal = palmd
+
+#endif // __SSE2__
+
 // this is almost never used (Wiz and menu bg gen only)
 void FinalizeLine32xRGB555(int sh, int line)
 {
@@ -125,8 +261,10 @@ void FinalizeLine32xRGB555(int sh, int line)
   }
 }
 
+#ifndef MD_LAYER_CODE
 #define MD_LAYER_CODE \
   *dst = palmd[*pmd]
+#endif
 
 #define PICOSCAN_PRE \
   PicoScan32xBegin(l + (lines_sft_offs & 0xff)); \
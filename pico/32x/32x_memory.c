@@ -71,6 +71,7 @@ static int m68k_poll_detect(u32 a, u32 cycles, u32 flags)
       if (!(Pico32x.emu_flags & flags)) {
         elprintf(EL_32X, "m68k poll addr %08x, cyc %u",
           a, cycles - m68k_poll.cycles);
+        pstat_add(PSTAT_POLL_SKIPS, 1);
         ret = 1;
       }
       Pico32x.emu_flags |= flags;
@@ -103,9 +104,11 @@ static void sh2_poll_detect(SH2 *sh2, u32 a, u32 flags, int maxcnt)
 
   if (a == sh2->poll_addr && sh2->poll_cycles - cycles_left <= 10) {
     if (sh2->poll_cnt++ > maxcnt) {
-      if (!(sh2->state & flags))
+      if (!(sh2->state & flags)) {
         elprintf_sh2(sh2, EL_32X, "state: %02x->%02x",
           sh2->state, sh2->state | flags);
+        pstat_add(PSTAT_POLL_SKIPS, 1);
+      }
 
       sh2->state |= flags;
       sh2_end_run(sh2, 1);
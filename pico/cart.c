@@ -13,6 +13,13 @@
 #include "../unzip/unzip.h"
 #include "../unzip/unzip_stream.h"
 
+#ifdef SHARED_ROM
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 
 static int rom_alloc_size;
 static const char *rom_exts[] = { "bin", "gen", "smd", "iso", "sms", "gg", "sg" };
@@ -21,6 +28,8 @@ void (*PicoCartUnloadHook)(void);
 void (*PicoCartMemSetup)(void);
 
 void (*PicoCartLoadProgressCB)(int percent) = NULL;
+const char *PicoCartCacheDir = NULL;
+const char *PicoCartShareDir = NULL;
 void (*PicoCDLoadProgressCB)(const char *fname, int percent) = NULL; // handled in Pico/cd/cd_file.c
 
 int PicoGameLoaded;
@@ -417,27 +426,99 @@ static int InterleveBlock(unsigned char *dest,unsigned char *src)
   return 0;
 }
 
-// Decode a SMD file
-static int DecodeSmd(unsigned char *data,int len)
+// ROM decoding, done on the part that's already read while the next
+// part is being read (and inflated)
+enum { ROM_DEC_NONE, ROM_DEC_SWAP, ROM_DEC_SMD };
+
+struct rom_decode {
+  unsigned char *rom;
+  int type;
+  int done;  // decoded up to here
+  int to;    // decode up to here now
+};
+
+static void rom_decode_job(void *arg)
 {
-  unsigned char *temp=NULL;
-  int i=0;
+  struct rom_decode *d = arg;
+  unsigned char temp[0x4000];
+  int i;
+
+  if (d->type == ROM_DEC_SWAP)
+    Byteswap(d->rom + d->done, d->rom + d->done, d->to - d->done);
+  else if (d->type == ROM_DEC_SMD) {
+    // Interleve each 16k block and shift down by 0x200
+    for (i = d->done; i < d->to; i += 0x4000) {
+      InterleveBlock(temp, d->rom + 0x200 + i);
+      memcpy(d->rom + i, temp, 0x4000);
+    }
+  }
+  d->done = d->to;
+}
 
-  temp=(unsigned char *)malloc(0x4000);
-  if (temp==NULL) return 1;
-  memset(temp,0,0x4000);
+// how far can we decode with 'avail' bytes of 'size' read?
+static int rom_decode_limit(int type, int avail, int size)
+{
+  if (type == ROM_DEC_SWAP)
+    return avail < size ? avail & ~3 : size;
+  if (type == ROM_DEC_SMD && avail >= 0x4200)
+    return (avail - 0x200) & ~0x3fff;
+  return 0;
+}
 
-  // Interleve each 16k block and shift down by 0x200:
-  for (i=0; i+0x4200<=len; i+=0x4000)
-  {
-    InterleveBlock(temp,data+0x200+i); // Interleve 16k to temporary buffer
-    memcpy(data+i,temp,0x4000); // Copy back in
+static int rom_decode_type(unsigned char *rom, int size, int is_sms)
+{
+  if (is_sms)
+    return ROM_DEC_NONE;
+
+  // maybe we are loading MegaCD BIOS?
+  if (!(PicoAHW & PAHW_MCD) && size == 0x20000 && (!strncmp((char *)rom+0x124, "BOOT", 4) ||
+       !strncmp((char *)rom+0x128, "BOOT", 4))) {
+    PicoAHW |= PAHW_MCD;
+  }
+
+  // Check for SMD:
+  if (size >= 0x4200 && (size&0x3fff) == 0x200 &&
+      ((rom[0x2280] == 'S' && rom[0x280] == 'E') || (rom[0x280] == 'S' && rom[0x2281] == 'E'))) {
+    elprintf(EL_STATUS, "SMD format detected.");
+    return ROM_DEC_SMD;
   }
+  return ROM_DEC_SWAP;
+}
+
+#ifndef NO_ZLIB
+// zipped ROMs can be kept unpacked in PicoCartCacheDir,
+// named after the CRC and size of the zip entry
+static int rom_cache_path(pm_file *f, char *path, int size)
+{
+  ZIP *zipfile = f->file;
+
+  if (PicoCartCacheDir == NULL || f->type != PMT_ZIP)
+    return -1;
 
-  free(temp);
+  snprintf(path, size, "%s/rom_%08x_%x.bin", PicoCartCacheDir,
+    zipfile->ent.crc32, f->size);
   return 0;
 }
 
+static FILE *rom_cache_open(pm_file *f, const char *path)
+{
+  FILE *cf;
+
+  cf = fopen(path, "rb");
+  if (cf == NULL)
+    return NULL;
+
+  fseek(cf, 0, SEEK_END);
+  if (ftell(cf) != f->size) {
+    fclose(cf);
+    return NULL;
+  }
+  fseek(cf, 0, SEEK_SET);
+  elprintf(EL_STATUS, "using unpacked ROM %s", path);
+  return cf;
+}
+#endif
+
 static unsigned char *PicoCartAlloc(int filesize, int is_sms)
 {
   unsigned char *rom;
@@ -473,10 +554,138 @@ static unsigned char *PicoCartAlloc(int filesize, int is_sms)
   return rom;
 }
 
+#ifdef SHARED_ROM
+// Decoded ROM images can be shared between processes: the image is
+// written to a file in PicoCartShareDir, named after its CRC and size,
+// and mapped privately. All instances then use the same page cache pages
+// and only the pages that are written to (patches, carthw) get copied.
+// Every user holds a shared lock on the file, the last one removes it.
+static int rom_share_fd = -1;
+static char rom_share_path[512];
+
+// private mapping of alloc_size with the shared image at the start
+static unsigned char *rom_share_map(int alloc_size, int file_size)
+{
+  unsigned char *mem;
+
+  mem = mmap((void *)0x02000000, alloc_size, PROT_READ | PROT_WRITE,
+    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (mem == MAP_FAILED)
+    return NULL;
+
+  if (mmap(mem, file_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED,
+       rom_share_fd, 0) == MAP_FAILED) {
+    munmap(mem, alloc_size);
+    return NULL;
+  }
+  return mem;
+}
+
+static int rom_share_write(const char *path, const unsigned char *rom, int size)
+{
+  char tmp[528];
+  int fd, ret;
+
+  // other instances may be writing it too
+  snprintf(tmp, sizeof(tmp), "%s.%d", path, (int)getpid());
+  fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0)
+    return -1;
+  ret = write(fd, rom, size);
+  if (close(fd) != 0 || ret != size || rename(tmp, path) != 0) {
+    unlink(tmp);
+    return -1;
+  }
+  return 0;
+}
+
+static int rom_share_open(const unsigned char *rom, int size)
+{
+  const char *path = rom_share_path;
+  unsigned int crc;
+  struct stat st;
+  int fd, tries;
+
+  crc = crc32(0, rom, size);
+  snprintf(rom_share_path, sizeof(rom_share_path), "%s/shared_%08x_%x.rom",
+    PicoCartShareDir, crc, size);
+
+  for (tries = 0; tries < 4; tries++) {
+    fd = open(path, O_RDONLY);
+    if (fd < 0) {
+      if (rom_share_write(path, rom, size) != 0)
+        return -1;
+      continue;
+    }
+
+    // the last user may have removed it between open and lock
+    if (flock(fd, LOCK_SH) == 0 && fstat(fd, &st) == 0 && st.st_nlink > 0) {
+      if (st.st_size == size)
+        return fd;
+      close(fd);
+      if (rom_share_write(path, rom, size) != 0)
+        return -1;
+      continue;
+    }
+    close(fd);
+  }
+
+  return -1;
+}
+
+static void rom_share_close(void)
+{
+  if (flock(rom_share_fd, LOCK_EX | LOCK_NB) == 0)
+    unlink(rom_share_path);
+  close(rom_share_fd);
+  rom_share_fd = -1;
+}
+
+// replace the loaded image with a mapping of the shared one
+static unsigned char *rom_share(unsigned char *rom, int size)
+{
+  unsigned char *img, *mem;
+  int fd;
+
+  fd = rom_share_open(rom, size);
+  if (fd < 0) {
+    elprintf(EL_STATUS, "can't share the ROM image");
+    return rom;
+  }
+
+  img = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (img == MAP_FAILED || memcmp(img, rom, size) != 0) {
+    elprintf(EL_STATUS, "shared ROM image mismatch");
+    if (img != MAP_FAILED)
+      munmap(img, size);
+    close(fd);
+    return rom;
+  }
+
+  // the old mapping goes first, so that the new one can take its address
+  plat_munmap(rom, rom_alloc_size);
+  rom_share_fd = fd;
+  mem = rom_share_map(rom_alloc_size, size);
+  if (mem == NULL) {
+    rom_share_close();
+    mem = plat_mmap(0x02000000, rom_alloc_size, 0, 0);
+    if (mem != NULL)
+      memcpy(mem, img, size);
+  }
+  munmap(img, size);
+
+  return mem;
+}
+#endif
+
 int PicoCartLoad(pm_file *f,unsigned char **prom,unsigned int *psize,int is_sms)
 {
+  struct pico_thread *thread = NULL;
+  struct rom_decode dec;
+  FILE *cache_in = NULL, *cache_out = NULL;
+  char cache_path[512], cache_tmp[516];
   unsigned char *rom;
-  int size, bytes_read;
+  int size, bytes_read, ret;
 
   if (f == NULL)
     return 1;
@@ -492,48 +701,87 @@ int PicoCartLoad(pm_file *f,unsigned char **prom,unsigned int *psize,int is_sms)
     return 2;
   }
 
-  if (PicoCartLoadProgressCB != NULL)
+#ifndef NO_ZLIB
+  if (rom_cache_path(f, cache_path, sizeof(cache_path)) == 0) {
+    cache_in = rom_cache_open(f, cache_path);
+    if (cache_in == NULL) {
+      snprintf(cache_tmp, sizeof(cache_tmp), "%s.tmp", cache_path);
+      cache_out = fopen(cache_tmp, "wb");
+    }
+  }
+#endif
+
+  // read ROM in blocks, decoding what's read so far on the helper thread
+  dec.rom = rom;
+  dec.type = -1;
+  dec.done = dec.to = 0;
+  if (f->size > 256*1024)
+    thread = pico_thread_create();
+
+  bytes_read = 0;
+  do
   {
-    // read ROM in blocks, just for fun
-    int ret;
-    unsigned char *p = rom;
-    bytes_read=0;
-    do
-    {
-      int todo = size - bytes_read;
-      if (todo > 256*1024) todo = 256*1024;
-      ret = pm_read(p,todo,f);
-      bytes_read += ret;
-      p += ret;
-      PicoCartLoadProgressCB(bytes_read * 100 / size);
+    int todo = f->size - bytes_read;
+    if (todo > 256*1024) todo = 256*1024;
+    if (cache_in != NULL)
+      ret = fread(rom + bytes_read, 1, todo, cache_in);
+    else
+      ret = pm_read(rom + bytes_read, todo, f);
+    if (ret <= 0)
+      break;
+    if (cache_out != NULL && fwrite(rom + bytes_read, 1, ret, cache_out) != ret) {
+      fclose(cache_out);
+      cache_out = NULL;
+      remove(cache_tmp);
     }
-    while (ret > 0);
+    bytes_read += ret;
+
+    if (thread != NULL)
+      pico_thread_wait(thread);
+    if (dec.type < 0 && bytes_read >= 0x2282)
+      dec.type = rom_decode_type(rom, size, is_sms);
+    if (dec.type > 0 && bytes_read < f->size) {
+      dec.to = rom_decode_limit(dec.type, bytes_read, size);
+      if (thread != NULL)
+        pico_thread_run(thread, rom_decode_job, &dec);
+      else
+        rom_decode_job(&dec);
+    }
+
+    if (PicoCartLoadProgressCB != NULL)
+      PicoCartLoadProgressCB(bytes_read * 100 / size);
   }
-  else
-    bytes_read = pm_read(rom,size,f); // Load up the rom
+  while (bytes_read < f->size);
+
+  if (thread != NULL) {
+    pico_thread_wait(thread);
+    pico_thread_destroy(thread);
+  }
+  if (cache_in != NULL)
+    fclose(cache_in);
+  if (cache_out != NULL) {
+    fclose(cache_out);
+    if (bytes_read == f->size)
+      remove(cache_path); // stale one, if any
+    if (bytes_read != f->size || rename(cache_tmp, cache_path) != 0)
+      remove(cache_tmp);
+  }
+
   if (bytes_read <= 0) {
     elprintf(EL_STATUS, "read failed");
-    free(rom);
+    plat_munmap(rom, rom_alloc_size);
     return 3;
   }
 
-  if (!is_sms)
-  {
-    // maybe we are loading MegaCD BIOS?
-    if (!(PicoAHW & PAHW_MCD) && size == 0x20000 && (!strncmp((char *)rom+0x124, "BOOT", 4) ||
-         !strncmp((char *)rom+0x128, "BOOT", 4))) {
-      PicoAHW |= PAHW_MCD;
-    }
+  if (dec.type < 0)
+    dec.type = rom_decode_type(rom, size, is_sms);
+  dec.to = rom_decode_limit(dec.type, size, size);
+  rom_decode_job(&dec);
 
-    // Check for SMD:
-    if (size >= 0x4200 && (size&0x3fff) == 0x200 &&
-        ((rom[0x2280] == 'S' && rom[0x280] == 'E') || (rom[0x280] == 'S' && rom[0x2281] == 'E'))) {
-      elprintf(EL_STATUS, "SMD format detected.");
-      DecodeSmd(rom,size); size-=0x200; // Decode and byteswap SMD
-    }
-    else Byteswap(rom, rom, size); // Just byteswap
-  }
-  else
+  if (dec.type == ROM_DEC_SMD)
+    size -= 0x200;
+
+  if (is_sms)
   {
     if (size >= 0x4200 && (size&0x3fff) == 0x200) {
       elprintf(EL_STATUS, "SMD format detected.");
@@ -543,6 +791,16 @@ int PicoCartLoad(pm_file *f,unsigned char **prom,unsigned int *psize,int is_sms)
     }
   }
 
+#ifdef SHARED_ROM
+  if (PicoCartShareDir != NULL) {
+    rom = rom_share(rom, size);
+    if (rom == NULL) {
+      elprintf(EL_STATUS, "out of memory (wanted %i)", rom_alloc_size);
+      return 2;
+    }
+  }
+#endif
+
   if (prom)  *prom = rom;
   if (psize) *psize = size;
 
@@ -609,7 +867,35 @@ int PicoCartInsert(unsigned char *rom, unsigned int romsize, const char *carthw_
 
 int PicoCartResize(int newsize)
 {
-  void *tmp = plat_mremap(Pico.rom, rom_alloc_size, newsize);
+  void *tmp;
+
+#ifdef SHARED_ROM
+  if (rom_share_fd >= 0) {
+    // map the shared image again and carry over the pages written to
+    struct stat st;
+    int i, len, page = sysconf(_SC_PAGESIZE);
+
+    if (fstat(rom_share_fd, &st) != 0)
+      return -1;
+    tmp = rom_share_map(newsize, st.st_size);
+    if (tmp == NULL)
+      return -1;
+
+    len = newsize < rom_alloc_size ? newsize : rom_alloc_size;
+    for (i = 0; i < len; i += page) {
+      int l = len - i < page ? len - i : page;
+      if (memcmp((char *)tmp + i, Pico.rom + i, l) != 0)
+        memcpy((char *)tmp + i, Pico.rom + i, l);
+    }
+    munmap(Pico.rom, rom_alloc_size);
+
+    Pico.rom = tmp;
+    rom_alloc_size = newsize;
+    return 0;
+  }
+#endif
+
+  tmp = plat_mremap(Pico.rom, rom_alloc_size, newsize);
   if (tmp == NULL)
     return -1;
 
@@ -618,6 +904,19 @@ int PicoCartResize(int newsize)
   return 0;
 }
 
+// release a ROM from PicoCartLoad(), for when it didn't get inserted
+void PicoCartFree(unsigned char *rom)
+{
+#ifdef SHARED_ROM
+  if (rom_share_fd >= 0) {
+    munmap(rom, rom_alloc_size);
+    rom_share_close();
+    return;
+  }
+#endif
+  plat_munmap(rom, rom_alloc_size);
+}
+
 void PicoCartUnload(void)
 {
   if (PicoCartUnloadHook != NULL) {
@@ -630,7 +929,7 @@ void PicoCartUnload(void)
 
   if (Pico.rom != NULL) {
     SekFinishIdleDet();
-    plat_munmap(Pico.rom, rom_alloc_size);
+    PicoCartFree(Pico.rom);
     Pico.rom = NULL;
   }
   PicoGameLoaded = 0;
@@ -34,27 +34,11 @@ u32 PicoReadM68k8_cell0(u32 a);
 u32 PicoReadM68k8_cell1(u32 a);
 u32 PicoReadM68k16_cell0(u32 a);
 u32 PicoReadM68k16_cell1(u32 a);
-void PicoWriteM68k8_cell0(u32 a, u32 d);
-void PicoWriteM68k8_cell1(u32 a, u32 d);
-void PicoWriteM68k16_cell0(u32 a, u32 d);
-void PicoWriteM68k16_cell1(u32 a, u32 d);
 
 u32 PicoReadS68k8_dec0(u32 a);
 u32 PicoReadS68k8_dec1(u32 a);
 u32 PicoReadS68k16_dec0(u32 a);
 u32 PicoReadS68k16_dec1(u32 a);
-void PicoWriteS68k8_dec_m0b0(u32 a, u32 d);
-void PicoWriteS68k8_dec_m1b0(u32 a, u32 d);
-void PicoWriteS68k8_dec_m2b0(u32 a, u32 d);
-void PicoWriteS68k8_dec_m0b1(u32 a, u32 d);
-void PicoWriteS68k8_dec_m1b1(u32 a, u32 d);
-void PicoWriteS68k8_dec_m2b1(u32 a, u32 d);
-void PicoWriteS68k16_dec_m0b0(u32 a, u32 d);
-void PicoWriteS68k16_dec_m1b0(u32 a, u32 d);
-void PicoWriteS68k16_dec_m2b0(u32 a, u32 d);
-void PicoWriteS68k16_dec_m0b1(u32 a, u32 d);
-void PicoWriteS68k16_dec_m1b1(u32 a, u32 d);
-void PicoWriteS68k16_dec_m2b1(u32 a, u32 d);
 #endif
 
 static void remap_prg_window(u32 r1, u32 r3);
@@ -253,6 +237,7 @@ u32 s68k_poll_detect(u32 a, u32 d)
       //printf("-- diff: %u, cnt = %i\n", clkdiff, cnt);
       if (Pico_mcd->m.s68k_poll_cnt > POLL_LIMIT) {
         SekSetStopS68k(1);
+        pstat_add(PSTAT_POLL_SKIPS, 1);
         elprintf(EL_CDPOLL, "s68k poll detected @%06x, a=%02x",
           SekPcS68k, a);
       }
@@ -266,6 +251,238 @@ u32 s68k_poll_detect(u32 a, u32 d)
   return d;
 }
 
+// s68k idle loops on RAM: a short loop that only reads a flag in PRG or
+// word RAM and branches back on it. The flag can only be changed by the
+// events and interrupts (CDC DMA, handlers) or the m68k, which all happen
+// between s68k timeslices, so if the s68k ends a slice in such a loop and
+// the flag still says to loop, it can be stopped until the flag changes
+// or an interrupt wakes it up.
+#ifdef USE_POLL_DETECT
+static u32 s68k_idle_bad_pc = ~0;
+
+static int s68k_idle_is_ram(u32 a, int sz)
+{
+  if ((a & 1) && sz > 1)
+    return 0;
+  if (map_flag_set(s68k_read8_map[(a & 0xffffff) >> M68K_MEM_SHIFT]))
+    return 0;
+  if (sz == 4 && map_flag_set(s68k_read8_map[((a + 2) & 0xffffff) >> M68K_MEM_SHIFT]))
+    return 0;
+  return 1;
+}
+
+// is op a short backward beq/bne/bra over at most 10 bytes?
+static int s68k_idle_is_bcc(u32 op)
+{
+  if ((op & 0xff00) != 0x6000 && (op & 0xfe00) != 0x6600)
+    return 0;
+  return !(op & 1) && (signed char)op < 0 && (signed char)op >= -12;
+}
+
+// decode the instruction a loop polls with, w: the loop words up to the
+// branch. 0 if it's not one that only tests memory
+static int s68k_idle_decode_cmp(const u16 *w, int bytes,
+  u32 *a, u32 *d, u32 *mask, int *sz)
+{
+  static const u32 masks[4] = { 0xff, 0xffff, 0xffffffff, 0 };
+  static const int move_s[4] = { -1, 0, 2, 1 };
+  u32 op = w[0], ea;
+  int len = 2, s = -1, r;
+
+  *d = *mask = 0;
+  if ((op & 0xffc0) == 0x0800) {      // btst #X, <ea>
+    s = 0;
+    *mask = 1 << (w[1] & 7);
+    len += 2;
+  }
+  else if ((op & 0xff00) == 0x0c00) { // cmpi.x #X, <ea>
+    s = (op >> 6) & 3;
+    *d = w[1];
+    if (s == 2)
+      *d = (*d << 16) | w[2];
+    len += s == 2 ? 4 : 2;
+  }
+  else if ((op & 0xff00) == 0x4a00)   // tst.x <ea>
+    s = (op >> 6) & 3;
+  else if ((op & 0xc1c0) == 0x0000 && (op & 0x3000)) // move.x <ea>, dX
+    s = move_s[(op >> 12) & 3];
+  else if ((op & 0xf100) == 0xb000) { // cmp.x <ea>, dX
+    s = (op >> 6) & 3;
+    r = (op >> 9) & 7;
+    *d = SekDarS68k(r);
+  }
+  if (s < 0 || s == 3)
+    return 0;
+
+  ea = op & 0x3f;
+  if ((ea & 0x38) == 0x10) {          // (aX)
+    r = 8 + (ea & 7);
+    *a = SekDarS68k(r);
+  }
+  else if (ea == 0x38) {              // ($xxxx.w)
+    *a = (signed short)w[len / 2];
+    len += 2;
+  }
+  else if (ea == 0x39) {              // ($xxxxxxxx)
+    *a = (w[len / 2] << 16) | w[len / 2 + 1];
+    len += 4;
+  }
+  else
+    return 0;
+  if (len != bytes)
+    return 0;
+
+  if (*mask == 0)
+    *mask = masks[s];
+  *d &= *mask;
+  *a &= 0xffffff;
+  *sz = 1 << s;
+  return 1;
+}
+
+// decode the loop the s68k is in at pc to s68k_idle_*, 0 if it's not
+// a loop that only polls RAM
+static int s68k_idle_decode(u32 pc)
+{
+  u16 w[5] = { 0, };
+  u32 start, op, a = 0, d = 0, mask = 0;
+  int bytes, sz = 0, i;
+
+  op = s68k_read16(pc);
+  if (s68k_idle_is_bcc(op)) {
+    bytes = -(signed char)op - 2;
+    start = pc - bytes;
+  }
+  else {
+    for (bytes = 2; bytes <= 10; bytes += 2) {
+      op = s68k_read16(pc + bytes);
+      if (s68k_idle_is_bcc(op) && (signed char)op == -bytes - 2)
+        break;
+    }
+    if (bytes > 10)
+      return 0;
+    start = pc;
+  }
+  Pico_mcd->m.s68k_idle_cc = op >> 8;
+
+  if (bytes == 0) {
+    // bra.s *
+    if (Pico_mcd->m.s68k_idle_cc != 0x60)
+      return 0;
+    Pico_mcd->m.s68k_idle_sz = 0;
+    return 1;
+  }
+
+  for (i = 0; i < bytes / 2; i++)
+    w[i] = s68k_read16(start + i * 2);
+  if (!s68k_idle_decode_cmp(w, bytes, &a, &d, &mask, &sz))
+    return 0;
+  if (!s68k_idle_is_ram(a, sz))
+    return 0;
+
+  Pico_mcd->m.s68k_idle_a = a;
+  Pico_mcd->m.s68k_idle_d = d;
+  Pico_mcd->m.s68k_idle_mask = mask;
+  Pico_mcd->m.s68k_idle_sz = sz;
+  return 1;
+}
+
+#ifndef NDEBUG
+// common polling instructions and what they must decode to
+static void s68k_idle_decode_check(void)
+{
+  static const struct {
+    u16 w[5];
+    int bytes, sz;
+    u32 a, d, mask;
+  } t[] = {
+    { { 0x0838, 0x0000, 0x8003 }, 6, 1, 0xff8003, 0, 0x01 }, // btst #0,$ff8003.w
+    { { 0x0838, 0x0007, 0x800f }, 6, 1, 0xff800f, 0, 0x80 }, // btst #7,$ff800f.w
+    { { 0x0c38, 0x0001, 0x8020 }, 6, 1, 0xff8020, 1, 0xff }, // cmpi.b #1,$ff8020.w
+    { { 0x0c79, 0x1234, 0x0000, 0x6000 }, 8, 2, 0x006000, 0x1234, 0xffff },
+                                                             // cmpi.w #$1234,$6000.l
+    { { 0x1038, 0x5000 }, 4, 1, 0x005000, 0, 0xff },         // move.b $5000.w,d0
+    { { 0x4a79, 0x0008, 0x0000 }, 6, 2, 0x080000, 0, 0xffff }, // tst.w $80000.l
+  };
+  u32 a, d, mask;
+  int i, sz;
+
+  for (i = 0; i < ARRAY_SIZE(t); i++) {
+    a = d = mask = sz = 0;
+    if (!s68k_idle_decode_cmp(t[i].w, t[i].bytes, &a, &d, &mask, &sz)
+        || a != t[i].a || d != t[i].d || mask != t[i].mask || sz != t[i].sz)
+      elprintf(EL_STATUS, "s68k idle decode check %d failed: "
+        "%06x %x %x %d", i, a, d, mask, sz);
+  }
+}
+#endif
+
+// would the decoded loop keep looping with what's in RAM now?
+static int s68k_idle_loops(void)
+{
+  u32 a = Pico_mcd->m.s68k_idle_a, v = 0;
+  int z;
+
+  switch (Pico_mcd->m.s68k_idle_sz) {
+    case 0: return 1;
+    case 1: v = s68k_read8(a); break;
+    case 2: v = s68k_read16(a); break;
+    case 4: v = s68k_read32(a); break;
+  }
+  z = (v & Pico_mcd->m.s68k_idle_mask) == Pico_mcd->m.s68k_idle_d;
+
+  switch (Pico_mcd->m.s68k_idle_cc) {
+    case 0x66: return !z;
+    case 0x67: return z;
+    default:   return 1;
+  }
+}
+#endif
+
+// called after an s68k timeslice
+void s68k_idle_detect(void)
+{
+#ifdef USE_POLL_DETECT
+  u32 pc;
+
+  if (SekIsStoppedS68k())
+    return;
+
+  pc = SekPcS68k & 0xffffff;
+  if (pc == s68k_idle_bad_pc)
+    return;
+  if (!s68k_idle_decode(pc)) {
+    Pico_mcd->m.s68k_idle_cc = 0;
+    s68k_idle_bad_pc = pc;
+    return;
+  }
+  if (!s68k_idle_loops()) {
+    Pico_mcd->m.s68k_idle_cc = 0;
+    return;
+  }
+
+  SekSetStopS68k(1);
+  pstat_add(PSTAT_POLL_SKIPS, 1);
+  elprintf(EL_CDPOLL, "s68k idle loop @%06x, a=%06x",
+    pc, Pico_mcd->m.s68k_idle_a);
+#endif
+}
+
+// called before an s68k timeslice while s68k_idle_cc is set
+void s68k_idle_check(void)
+{
+#ifdef USE_POLL_DETECT
+  if (SekIsStoppedS68k()) {
+    if (s68k_idle_loops())
+      return;
+    elprintf(EL_CDPOLL, "s68k idle release, a=%06x",
+      Pico_mcd->m.s68k_idle_a);
+    SekSetStopS68k(0);
+  }
+  Pico_mcd->m.s68k_idle_cc = 0;
+#endif
+}
+
 #define READ_FONT_DATA(basemask) \
 { \
       unsigned int fnt = *(unsigned int *)(Pico_mcd->s68k_regs + 0x4c); \
@@ -357,7 +574,11 @@ void s68k_reg_write8(u32 a, u32 d)
       {
         if (!(dold & 4)) {
           elprintf(EL_CDREG3, "wram mode 2M->1M");
-          wram_2M_to_1M(Pico_mcd->word_ram2M);
+          if (!Pico_mcd->m.wram_dual) {
+            // first use of 1M, keep both layouts from now on
+            wram_2M_to_1M(Pico_mcd->word_ram2M, Pico_mcd->word_ram1M[0]);
+            Pico_mcd->m.wram_dual = 1;
+          }
         }
 
         if ((d ^ dold) & 0x1d)
@@ -370,7 +591,6 @@ void s68k_reg_write8(u32 a, u32 d)
       {
         if (dold & 4) {
           elprintf(EL_CDREG3, "wram mode 1M->2M");
-          wram_1M_to_2M(Pico_mcd->word_ram2M);
           remap_word_ram(d);
         }
         d = (d & ~3) | Pico_mcd->m.dmna_ret_2m;
@@ -544,58 +764,88 @@ write_comm:
 //                          Main 68k
 // -----------------------------------------------------------------
 
-#ifndef _ASM_CD_MEMORY_C
 #include "cell_map.c"
 
+// "cell arrange" translation, 4 byte units
+unsigned short pcd_cell_map[0x8000];
+
+#ifndef _ASM_CD_MEMORY_C
 // WORD RAM, cell aranged area (220000 - 23ffff)
 static u32 PicoReadM68k8_cell0(u32 a)
 {
-  a = (a&3) | (cell_map(a >> 2) << 2); // cell arranged
+  a = PCD_CELL_ADDR(a); // cell arranged
   return Pico_mcd->word_ram1M[0][a ^ 1];
 }
 
 static u32 PicoReadM68k8_cell1(u32 a)
 {
-  a = (a&3) | (cell_map(a >> 2) << 2);
+  a = PCD_CELL_ADDR(a);
   return Pico_mcd->word_ram1M[1][a ^ 1];
 }
 
 static u32 PicoReadM68k16_cell0(u32 a)
 {
-  a = (a&2) | (cell_map(a >> 2) << 2);
+  a = PCD_CELL_ADDR(a) & ~1;
   return *(u16 *)(Pico_mcd->word_ram1M[0] + a);
 }
 
 static u32 PicoReadM68k16_cell1(u32 a)
 {
-  a = (a&2) | (cell_map(a >> 2) << 2);
+  a = PCD_CELL_ADDR(a) & ~1;
   return *(u16 *)(Pico_mcd->word_ram1M[1] + a);
 }
+#endif
 
-static void PicoWriteM68k8_cell0(u32 a, u32 d)
+// word RAM writes, these also update the other layout
+static void PicoWrite8_wram_2M(u32 a, u32 d)
 {
-  a = (a&3) | (cell_map(a >> 2) << 2);
-  Pico_mcd->word_ram1M[0][a ^ 1] = d;
+  a = (a & 0x3ffff) ^ 1;
+  Pico_mcd->word_ram2M[a] = d;
+  Pico_mcd->word_ram1M[WRAM_1M_BANK(a)][WRAM_1M_OFFS(a)] = d;
 }
 
-static void PicoWriteM68k8_cell1(u32 a, u32 d)
+static void PicoWrite16_wram_2M(u32 a, u32 d)
 {
-  a = (a&3) | (cell_map(a >> 2) << 2);
-  Pico_mcd->word_ram1M[1][a ^ 1] = d;
+  a &= 0x3fffe;
+  *(u16 *)(Pico_mcd->word_ram2M + a) = d;
+  *(u16 *)(Pico_mcd->word_ram1M[WRAM_1M_BANK(a)] + WRAM_1M_OFFS(a)) = d;
 }
 
-static void PicoWriteM68k16_cell0(u32 a, u32 d)
-{
-  a = (a&3) | (cell_map(a >> 2) << 2);
-  *(u16 *)(Pico_mcd->word_ram1M[0] + a) = d;
+#define mk_wram_1M_w(bank)                                        \
+static void PicoWrite8_wram_1M_b##bank(u32 a, u32 d)              \
+{                                                                 \
+  a = (a & 0x1ffff) ^ 1;                                          \
+  Pico_mcd->word_ram1M[bank][a] = d;                              \
+  Pico_mcd->word_ram2M[WRAM_2M_OFFS(bank, a)] = d;                \
+}                                                                 \
+                                                                  \
+static void PicoWrite16_wram_1M_b##bank(u32 a, u32 d)             \
+{                                                                 \
+  a &= 0x1fffe;                                                   \
+  *(u16 *)(Pico_mcd->word_ram1M[bank] + a) = d;                   \
+  *(u16 *)(Pico_mcd->word_ram2M + WRAM_2M_OFFS(bank, a)) = d;     \
 }
 
-static void PicoWriteM68k16_cell1(u32 a, u32 d)
-{
-  a = (a&3) | (cell_map(a >> 2) << 2);
-  *(u16 *)(Pico_mcd->word_ram1M[1] + a) = d;
+mk_wram_1M_w(0)
+mk_wram_1M_w(1)
+
+#define mk_cell_w(bank)                                           \
+static void PicoWriteM68k8_cell##bank(u32 a, u32 d)               \
+{                                                                 \
+  a = PCD_CELL_ADDR(a) ^ 1;                                       \
+  Pico_mcd->word_ram1M[bank][a] = d;                              \
+  Pico_mcd->word_ram2M[WRAM_2M_OFFS(bank, a)] = d;                \
+}                                                                 \
+                                                                  \
+static void PicoWriteM68k16_cell##bank(u32 a, u32 d)              \
+{                                                                 \
+  a = PCD_CELL_ADDR(a) & ~1;                                      \
+  *(u16 *)(Pico_mcd->word_ram1M[bank] + a) = d;                   \
+  *(u16 *)(Pico_mcd->word_ram2M + WRAM_2M_OFFS(bank, a)) = d;     \
 }
-#endif
+
+mk_cell_w(0)
+mk_cell_w(1)
 
 // RAM cart (40000 - 7fffff, optional)
 static u32 PicoReadM68k8_ramc(u32 a)
@@ -792,17 +1042,20 @@ static u32 PicoReadS68k16_dec1(u32 a)
   d &= ~0xf0;
   return d;
 }
+#endif
 
 /* check: jaguar xj 220 (draws entire world using decode) */
 #define mk_decode_w8(bank)                                        \
 static void PicoWriteS68k8_dec_m0b##bank(u32 a, u32 d)            \
 {                                                                 \
-  u8 *pd = &Pico_mcd->word_ram1M[bank][((a >> 1) ^ 1) & 0x1ffff]; \
+  u32 o = ((a >> 1) ^ 1) & 0x1ffff;                               \
+  u8 *pd = &Pico_mcd->word_ram1M[bank][o];                        \
                                                                   \
   if (!(a & 1))                                                   \
     *pd = (*pd & 0x0f) | (d << 4);                                \
   else                                                            \
     *pd = (*pd & 0xf0) | (d & 0x0f);                              \
+  Pico_mcd->word_ram2M[WRAM_2M_OFFS(bank, o)] = *pd;              \
 }                                                                 \
                                                                   \
 static void PicoWriteS68k8_dec_m1b##bank(u32 a, u32 d)            \
@@ -826,24 +1079,29 @@ mk_decode_w8(1)
 #define mk_decode_w16(bank)                                       \
 static void PicoWriteS68k16_dec_m0b##bank(u32 a, u32 d)           \
 {                                                                 \
-  u8 *pd = &Pico_mcd->word_ram1M[bank][((a >> 1) ^ 1) & 0x1ffff]; \
+  u32 o = ((a >> 1) ^ 1) & 0x1ffff;                               \
+  u8 *pd = &Pico_mcd->word_ram1M[bank][o];                        \
                                                                   \
   d &= 0x0f0f;                                                    \
   *pd = d | (d >> 4);                                             \
+  Pico_mcd->word_ram2M[WRAM_2M_OFFS(bank, o)] = *pd;              \
 }                                                                 \
                                                                   \
 static void PicoWriteS68k16_dec_m1b##bank(u32 a, u32 d)           \
 {                                                                 \
-  u8 *pd = &Pico_mcd->word_ram1M[bank][((a >> 1) ^ 1) & 0x1ffff]; \
+  u32 o = ((a >> 1) ^ 1) & 0x1ffff;                               \
+  u8 *pd = &Pico_mcd->word_ram1M[bank][o];                        \
                                                                   \
   d &= 0x0f0f; /* underwrite */                                   \
   if (!(*pd & 0xf0)) *pd |= d >> 4;                               \
   if (!(*pd & 0x0f)) *pd |= d;                                    \
+  Pico_mcd->word_ram2M[WRAM_2M_OFFS(bank, o)] = *pd;              \
 }                                                                 \
                                                                   \
 static void PicoWriteS68k16_dec_m2b##bank(u32 a, u32 d)           \
 {                                                                 \
-  u8 *pd = &Pico_mcd->word_ram1M[bank][((a >> 1) ^ 1) & 0x1ffff]; \
+  u32 o = ((a >> 1) ^ 1) & 0x1ffff;                               \
+  u8 *pd = &Pico_mcd->word_ram1M[bank][o];                        \
                                                                   \
   d &= 0x0f0f; /* overwrite */                                    \
   d |= d >> 4;                                                    \
@@ -851,13 +1109,12 @@ static void PicoWriteS68k16_dec_m2b##bank(u32 a, u32 d)           \
   if (!(d & 0xf0)) d |= *pd & 0xf0;                               \
   if (!(d & 0x0f)) d |= *pd & 0x0f;                               \
   *pd = d;                                                        \
+  Pico_mcd->word_ram2M[WRAM_2M_OFFS(bank, o)] = d;                \
 }
 
 mk_decode_w16(0)
 mk_decode_w16(1)
 
-#endif
-
 // backup RAM (fe0000 - feffff)
 static u32 PicoReadS68k8_bram(u32 a)
 {
@@ -1009,6 +1266,9 @@ static void PicoWriteS68k16_pr(u32 a, u32 d)
 
 #endif
 
+static const void *wram_1M_write8[]  = { PicoWrite8_wram_1M_b0, PicoWrite8_wram_1M_b1 };
+static const void *wram_1M_write16[] = { PicoWrite16_wram_1M_b0, PicoWrite16_wram_1M_b1 };
+
 static const void *m68k_cell_read8[]   = { PicoReadM68k8_cell0, PicoReadM68k8_cell1 };
 static const void *m68k_cell_read16[]  = { PicoReadM68k16_cell0, PicoReadM68k16_cell1 };
 static const void *m68k_cell_write8[]  = { PicoWriteM68k8_cell0, PicoWriteM68k8_cell1 };
@@ -1053,14 +1313,24 @@ static void remap_word_ram(u32 r3)
     cpu68k_map_all_ram(0x200000, 0x23ffff, bank, 0);
     cpu68k_map_all_ram(0x080000, 0x0bffff, bank, 1);
     // TODO: handle 0x0c0000
+    if (Pico_mcd->m.wram_dual) {
+      cpu68k_map_set(m68k_write8_map,  0x200000, 0x23ffff, PicoWrite8_wram_2M, 1);
+      cpu68k_map_set(m68k_write16_map, 0x200000, 0x23ffff, PicoWrite16_wram_2M, 1);
+      cpu68k_map_set(s68k_write8_map,  0x080000, 0x0bffff, PicoWrite8_wram_2M, 1);
+      cpu68k_map_set(s68k_write16_map, 0x080000, 0x0bffff, PicoWrite16_wram_2M, 1);
+    }
   }
   else {
     int b0 = r3 & 1;
     int m = (r3 & 0x18) >> 3;
     bank = Pico_mcd->word_ram1M[b0];
     cpu68k_map_all_ram(0x200000, 0x21ffff, bank, 0);
+    cpu68k_map_set(m68k_write8_map,  0x200000, 0x21ffff, wram_1M_write8[b0], 1);
+    cpu68k_map_set(m68k_write16_map, 0x200000, 0x21ffff, wram_1M_write16[b0], 1);
     bank = Pico_mcd->word_ram1M[b0 ^ 1];
     cpu68k_map_all_ram(0x0c0000, 0x0effff, bank, 1);
+    cpu68k_map_set(s68k_write8_map,  0x0c0000, 0x0effff, wram_1M_write8[b0 ^ 1], 1);
+    cpu68k_map_set(s68k_write16_map, 0x0c0000, 0x0effff, wram_1M_write16[b0 ^ 1], 1);
     // "cell arrange" on m68k
     cpu68k_map_set(m68k_read8_map,   0x220000, 0x23ffff, m68k_cell_read8[b0], 1);
     cpu68k_map_set(m68k_read16_map,  0x220000, 0x23ffff, m68k_cell_read16[b0], 1);
@@ -1095,8 +1365,12 @@ void pcd_state_loaded_mem(void)
   u32 r3 = Pico_mcd->s68k_regs[3];
 
   /* after load events */
-  if (r3 & 4) // 1M mode?
-    wram_2M_to_1M(Pico_mcd->word_ram2M);
+  // word RAM is saved in 2M layout only
+  Pico_mcd->m.wram_dual = 0;
+  if (r3 & 4) { // 1M mode?
+    wram_2M_to_1M(Pico_mcd->word_ram2M, Pico_mcd->word_ram1M[0]);
+    Pico_mcd->m.wram_dual = 1;
+  }
   remap_word_ram(r3);
   remap_prg_window(Pico_mcd->m.busreq, r3);
   Pico_mcd->m.dmna_ret_2m &= 3;
@@ -1111,9 +1385,15 @@ static void m68k_mem_setup_cd(void);
 
 PICO_INTERNAL void PicoMemSetupCD(void)
 {
+  int i;
+
   // setup default main68k map
   PicoMemSetup();
 
+#if defined(USE_POLL_DETECT) && !defined(NDEBUG)
+  s68k_idle_decode_check();
+#endif
+
   // main68k map (BIOS mapped by PicoMemSetup()):
   // RAM cart
   if (PicoOpt & POPT_EN_MCD_RAMCART) {
@@ -1158,6 +1438,9 @@ PICO_INTERNAL void PicoMemSetupCD(void)
   // RAMs
   remap_word_ram(1);
 
+  for (i = 0; i < 0x8000; i++)
+    pcd_cell_map[i] = cell_map(i);
+
 #ifdef EMU_C68K
   // s68k
   PicoCpuCS68k.read8  = (void *)s68k_read8_map;
@@ -1179,6 +1462,10 @@ PICO_INTERNAL void PicoMemSetupCD(void)
   PicoCpuFS68k.write_byte = s68k_write8;
   PicoCpuFS68k.write_word = s68k_write16;
   PicoCpuFS68k.write_long = s68k_write32;
+  PicoCpuFS68k.read8_map   = s68k_read8_map;
+  PicoCpuFS68k.read16_map  = s68k_read16_map;
+  PicoCpuFS68k.write8_map  = s68k_write8_map;
+  PicoCpuFS68k.write16_map = s68k_write16_map;
 
   // setup FAME fetchmap
   {
@@ -24,43 +24,47 @@ unsigned char formatted_bram[4*0x10] =
 };
 
 
-// offs | 2Mbit  | 1Mbit  |
-//   0  | [ 2M   | unused |
-// 128K |  bit ] | bank0  |
-// 256K | unused | bank1  |
+// word RAM is kept in separate 2M and 1M layout buffers, 1M banks are
+// the even and odd words of 2M:
+// 2M   | w0 w1 w2 w3 ...
+// 1M b0| w0 w2 ...
+// 1M b1| w1 w3 ...
 
 #ifndef _ASM_MISC_C
-PICO_INTERNAL_ASM void wram_2M_to_1M(unsigned char *m)
+PICO_INTERNAL_ASM void wram_2M_to_1M(const unsigned char *m2M, unsigned char *m1M)
 {
 	unsigned short *m1M_b0, *m1M_b1;
-	unsigned int i, tmp, *m2M;
+	const unsigned int *m2M32;
+	unsigned int i, tmp;
 
-	m2M = (unsigned int *) (m + 0x40000);
-	m1M_b0 = (unsigned short *) m2M;
-	m1M_b1 = (unsigned short *) (m + 0x60000);
+	m2M32 = (const unsigned int *) m2M;
+	m1M_b0 = (unsigned short *) m1M;
+	m1M_b1 = (unsigned short *) (m1M + 0x20000);
 
 	for (i = 0x40000/4; i; i--)
 	{
-		tmp = *(--m2M);
-		*(--m1M_b0) = tmp;
-		*(--m1M_b1) = tmp >> 16;
+		tmp = *m2M32++;
+		*m1M_b0++ = tmp;
+		*m1M_b1++ = tmp >> 16;
 	}
 }
+#endif
 
-PICO_INTERNAL_ASM void wram_1M_to_2M(unsigned char *m)
+// propagate a written range (2M offset, bytes) to the 1M layout
+PICO_INTERNAL void wram_2M_to_1M_range(unsigned int a, int len)
 {
-	unsigned short *m1M_b0, *m1M_b1;
-	unsigned int i, tmp, *m2M;
+	unsigned short *m2M = (unsigned short *)Pico_mcd->word_ram2M;
 
-	m2M = (unsigned int *) m;
-	m1M_b0 = (unsigned short *) (m + 0x20000);
-	m1M_b1 = (unsigned short *) (m + 0x40000);
+	for (a &= ~1; len > 0; a += 2, len -= 2)
+		*(unsigned short *)(Pico_mcd->word_ram1M[WRAM_1M_BANK(a)] + WRAM_1M_OFFS(a)) = m2M[a / 2];
+}
 
-	for (i = 0x40000/4; i; i--)
-	{
-		tmp = *m1M_b0++ | (*m1M_b1++ << 16);
-		*m2M++ = tmp;
-	}
+// same for a range written to a 1M bank
+PICO_INTERNAL void wram_1M_to_2M_range(int bank, unsigned int a, int len)
+{
+	unsigned short *m1M = (unsigned short *)Pico_mcd->word_ram1M[bank];
+
+	for (a &= ~1; len > 0; a += 2, len -= 2)
+		*(unsigned short *)(Pico_mcd->word_ram2M + WRAM_2M_OFFS(bank, a)) = m1M[a / 2];
 }
-#endif
 
@@ -36,6 +36,7 @@
  *
  ****************************************************************************************/
 
+#include <stddef.h>
 #include "../pico_int.h"
 #include "genplus_macros.h"
 
@@ -244,98 +245,82 @@ int cdc_context_load_old(uint8 *state)
 #undef old_load
 }
 
+/* DMA destinations, indexed by dma_type: where the memory is in Pico_mcd,
+ * the DMA address register unit, the address mask and the memory size.
+ * Everything except PCM RAM is stored byteswapped. */
+static const struct {
+  int offs;
+  int shift;
+  int mask;
+  int size;
+} dma_dst[] = {
+  { 0, 3 },
+  { offsetof(mcd_state, word_ram1M[0]), 3, 0x1fffe, 0x20000 },
+  { offsetof(mcd_state, word_ram1M[1]), 3, 0x1fffe, 0x20000 },
+  { offsetof(mcd_state, word_ram2M),    3, 0x3fffe, 0x40000 },
+  { offsetof(mcd_state, pcm_ram),       2, 0x00ffc, 0x01000 },
+  { offsetof(mcd_state, prg_ram),       3, 0x7fffe, 0x80000 },
+};
+
+/* copy len bytes from the CDC buffer at src, split where the buffer wraps */
+static void dma_copy(uint8 *dst, int src, int len, int swap)
+{
+  int l;
+
+  while (len > 0)
+  {
+    l = len;
+    if (src + l > 0x4000)
+      l = 0x4000 - src;
+    if (swap)
+      memcpy16bswap((void *)dst, cdc.ram + src, l / 2);
+    else
+      memcpy(dst, cdc.ram + src, l);
+    dst += l;
+    src = (src + l) & 0x3fff;
+    len -= l;
+  }
+}
+
 static void do_dma(enum dma_type type, int words_in)
 {
-	int dma_addr = (Pico_mcd->s68k_regs[0x0a] << 8) | Pico_mcd->s68k_regs[0x0b];
+  int dma_addr = (Pico_mcd->s68k_regs[0x0a] << 8) | Pico_mcd->s68k_regs[0x0b];
   int src_addr = cdc.dac & 0x3ffe;
-  int dst_addr = dma_addr;
-  int words = words_in;
-  int dst_limit = 0;
+  int len = words_in * 2;
+  int dst_addr;
   uint8 *dst;
-  int len;
 
   elprintf(EL_CD, "dma %d %04x->%04x %x",
-    type, cdc.dac, dst_addr, words_in);
-
-  switch (type)
-  {
-    case pcm_ram_dma_w:
-      dst_addr = (dst_addr << 2) & 0xffc;
-      if (dst_addr + words * 2 > 0x1000) {
-        elprintf(EL_ANOMALY, "pcm dma oflow: %x %x", dst_addr, words);
-        words = (0x1000 - dst_addr) / 2;
-      }
-      dst = Pico_mcd->pcm_ram_b[Pico_mcd->pcm.bank];
-      dst = dst + dst_addr;
-      while (words > 0)
-      {
-        if (src_addr + words * 2 > 0x4000) {
-          len = 0x4000 - src_addr;
-          memcpy(dst, cdc.ram + src_addr, len);
-          dst += len;
-          src_addr = 0;
-          words -= len / 2;
-          continue;
-        }
-        memcpy(dst, cdc.ram + src_addr, words * 2);
-        break;
-      }
-      goto update_dma;
-
-    case prg_ram_dma_w:
-      dst_addr <<= 3;
-		  dst = Pico_mcd->prg_ram + dst_addr;
-      dst_limit = 0x80000;
-      break;
-
-    case word_ram_0_dma_w:
-      dst_addr = (dst_addr << 3) & 0x1fffe;
-			dst = Pico_mcd->word_ram1M[0] + dst_addr;
-      dst_limit = 0x20000;
-      break;
-
-    case word_ram_1_dma_w:
-      dst_addr = (dst_addr << 3) & 0x1fffe;
-			dst = Pico_mcd->word_ram1M[1] + dst_addr;
-      dst_limit = 0x20000;
-      break;
-
-    case word_ram_2M_dma_w:
-      dst_addr = (dst_addr << 3) & 0x3fffe;
-			dst = Pico_mcd->word_ram2M + dst_addr;
-      dst_limit = 0x40000;
-      break;
+    type, cdc.dac, dma_addr, words_in);
 
-    default:
-      elprintf(EL_ANOMALY, "invalid dma: %d", type);
-      goto update_dma;
+  if (type < word_ram_0_dma_w || type > prg_ram_dma_w) {
+    elprintf(EL_ANOMALY, "invalid dma: %d", type);
+    type = 0;
+    goto update_dma;
   }
 
-  if (dst_addr + words * 2 > dst_limit) {
-    elprintf(EL_ANOMALY, "cd dma %d oflow: %x %x", type, dst_addr, words);
-    words = (dst_limit - dst_addr) / 2;
-  }
-  while (words > 0)
-  {
-    if (src_addr + words * 2 > 0x4000) {
-      len = 0x4000 - src_addr;
-      memcpy16bswap((void *)dst, cdc.ram + src_addr, len / 2);
-      dst += len;
-      src_addr = 0;
-      words -= len / 2;
-      continue;
-    }
-    memcpy16bswap((void *)dst, cdc.ram + src_addr, words);
-    break;
+  /* whole destination span, clipped to the end of the memory */
+  dst_addr = (dma_addr << dma_dst[type].shift) & dma_dst[type].mask;
+  if (dst_addr + len > dma_dst[type].size) {
+    elprintf(EL_ANOMALY, "cd dma %d oflow: %x %x", type, dst_addr, words_in);
+    len = dma_dst[type].size - dst_addr;
   }
 
+  dst = (uint8 *)Pico_mcd + dma_dst[type].offs + dst_addr;
+  if (type == pcm_ram_dma_w)
+    dst += Pico_mcd->pcm.bank * 0x1000;
+  dma_copy(dst, src_addr, len, type != pcm_ram_dma_w);
+
+  /* keep the other word RAM layout up to date */
+  if (type == word_ram_0_dma_w || type == word_ram_1_dma_w)
+    wram_1M_to_2M_range(type == word_ram_1_dma_w, dst_addr, len);
+  else if (type == word_ram_2M_dma_w && Pico_mcd->m.wram_dual)
+    wram_2M_to_1M_range(dst_addr, len);
+
 update_dma:
   /* update DMA addresses */
   cdc.dac += words_in * 2;
-  if (type == pcm_ram_dma_w)
-    dma_addr += words_in >> 1;
-  else
-    dma_addr += words_in >> 2;
+  dma_addr += (words_in * 2) >> dma_dst[type].shift;
 
   Pico_mcd->s68k_regs[0x0a] = dma_addr >> 8;
   Pico_mcd->s68k_regs[0x0b] = dma_addr;
@@ -843,4 +828,10 @@ unsigned short cdc_host_r(void)
   return 0xffff;
 }
 
+/* previous data block was taken: decoder irq acknowledged, no transfer running */
+int cdc_decoder_idle(void)
+{
+  return (cdc.ifstat & (BIT_DECI | BIT_DTBSY)) == (BIT_DECI | BIT_DTBSY);
+}
+
 // vim:shiftwidth=2:ts=2:expandtab
@@ -885,6 +885,12 @@ void cdd_update(void)
   }
 }
 
+/* drive is delivering DATA track blocks */
+int cdd_reading_data(void)
+{
+  return cdd.status == CD_PLAY && !cdd.index && !cdd.latency;
+}
+
 #define set_reg16(r, v) { \
   uint16 _v = v; \
   Pico_mcd->s68k_regs[(r)] = _v >> 8; \
@@ -1026,6 +1032,7 @@ void cdd_process(void)
     {
       /* reset track index */
       int index = 0;
+      int seek;
 
       /* new LBA position */
       int lba = ((Pico_mcd->s68k_regs[0x44+0] * 10 + Pico_mcd->s68k_regs[0x44+1]) * 60 + 
@@ -1050,11 +1057,11 @@ void cdd_process(void)
       /* be enough delayed to start in sync with intro sequence, as compared with real hardware recording).        */
       if (lba > cdd.lba)
       {
-        cdd.latency += (((lba - cdd.lba) * 120) / 270000);
+        seek = (((lba - cdd.lba) * 120) / 270000);
       }
       else 
       {
-        cdd.latency += (((cdd.lba - lba) * 120) / 270000);
+        seek = (((cdd.lba - lba) * 120) / 270000);
       }
 
       /* update current LBA */
@@ -1086,6 +1093,13 @@ void cdd_process(void)
       /* update current track index */
       cdd.index = index;
 
+      /* fast drive mode: shorter seek time to DATA track (minimal delay is kept) */
+      if ((PicoOpt & POPT_EN_MCD_FASTCD) && !index)
+      {
+        seek /= CDD_FAST_MULT;
+      }
+      cdd.latency += seek;
+
       /* stay within track limits when seeking files */
       if (lba < cdd.toc.tracks[index].start) 
       {
@@ -1185,6 +1199,12 @@ void cdd_process(void)
       /* update current track index */
       cdd.index = index;
 
+      /* fast drive mode: shorter seek time to DATA track */
+      if ((PicoOpt & POPT_EN_MCD_FASTCD) && !index)
+      {
+        cdd.latency /= CDD_FAST_MULT;
+      }
+
       /* stay within track limits */
       if (lba < cdd.toc.tracks[index].start) 
       {
@@ -292,6 +292,11 @@ static void gfx_render(uint32 bufferIndex, uint32 width)
 
     /* write data to image buffer */
     WRITE_BYTE(Pico_mcd->word_ram2M, bufferIndex >> 1, pixel_out);
+    if (Pico_mcd->m.wram_dual) {
+      /* keep 1M layout up to date */
+      uint32 a = (bufferIndex >> 1) ^ 1;
+      Pico_mcd->word_ram1M[WRAM_1M_BANK(a)][WRAM_1M_OFFS(a)] = pixel_out;
+    }
 
     /* check current pixel position  */
     if ((bufferIndex & 7) != 7)
@@ -8,8 +8,6 @@
 
 #include "../pico_int.h"
 
-#include "cell_map.c"
-
 #ifndef UTYPES_DEFINED
 typedef unsigned short u16;
 #endif
@@ -29,25 +27,32 @@ PICO_INTERNAL void DmaSlowCell(unsigned int source, unsigned int a, int len, uns
       r = Pico.vram;
       for(; len; len--)
       {
-        asrc = cell_map(source >> 2) << 2;
-        asrc |= source & 2;
+        asrc = PCD_CELL_ADDR(source) & ~1;
         // if(a&1) d=(d<<8)|(d>>8); // ??
         r[a>>1] = *(u16 *)(base + asrc);
 	source += 2;
         // AutoIncrement
         a=(u16)(a+inc);
       }
+      if (DrawThreaded) {
+        PicoDrawLog(DLOG_VRAM, 0, 0x8000);
+        break;
+      }
+      PicoSprDirtyAll();
+      PicoTileDirtyAll();
       rendstatus |= PDRAW_SPRITES_MOVED;
       break;
 
     case 3: // cram
-      Pico.m.dirtyPal = 1;
+      if (!DrawThreaded)
+        Pico.m.dirtyPal = 1;
       r = Pico.cram;
       for(a2=a&0x7f; len; len--)
       {
-        asrc = cell_map(source >> 2) << 2;
-        asrc |= source & 2;
+        asrc = PCD_CELL_ADDR(source) & ~1;
         r[a2>>1] = *(u16 *)(base + asrc);
+        if (!DrawThreaded)
+          PicoPalDirtyEntry(a2>>1);
 	source += 2;
         // AutoIncrement
         a2+=inc;
@@ -55,14 +60,15 @@ PICO_INTERNAL void DmaSlowCell(unsigned int source, unsigned int a, int len, uns
         if(a2 >= 0x80) break;
       }
       a=(a&0xff00)|a2;
+      if (DrawThreaded)
+        PicoDrawLog(DLOG_CRAM, 0, 0x40);
       break;
 
     case 5: // vsram[a&0x003f]=d;
       r = Pico.vsram;
       for(a2=a&0x7f; len; len--)
       {
-        asrc = cell_map(source >> 2) << 2;
-        asrc |= source & 2;
+        asrc = PCD_CELL_ADDR(source) & ~1;
         r[a2>>1] = *(u16 *)(base + asrc);
 	source += 2;
         // AutoIncrement
@@ -71,6 +77,8 @@ PICO_INTERNAL void DmaSlowCell(unsigned int source, unsigned int a, int len, uns
         if(a2 >= 0x80) break;
       }
       a=(a&0xff00)|a2;
+      if (DrawThreaded)
+        PicoDrawLog(DLOG_VSRAM, 0, 0x40);
       break;
   }
   // remember addr
@@ -93,6 +93,7 @@ PICO_INTERNAL int PicoResetMCD(void)
 
 static void SekRunM68kOnce(void)
 {
+  unsigned int cyc_start = SekCycleCnt;
   int cyc_do;
   pevt_log_m68k_o(EVT_RUN_START);
 
@@ -111,6 +112,7 @@ static void SekRunM68kOnce(void)
   }
 
   SekCyclesLeft = 0;
+  pstat_add(PSTAT_M68K_CYCLES, SekCycleCnt - cyc_start);
 
   SekTrace(0);
   pevt_log_m68k_o(EVT_RUN_END);
@@ -118,6 +120,7 @@ static void SekRunM68kOnce(void)
 
 static void SekRunS68k(unsigned int to)
 {
+  unsigned int cyc_start = SekCycleCntS68k;
   int cyc_do;
 
   SekCycleAimS68k = to;
@@ -141,6 +144,7 @@ static void SekRunS68k(unsigned int to)
   SekCycleCntS68k += fm68k_emulate(cyc_do, 0) - cyc_do;
   g_m68kcontext = &PicoCpuFM68k;
 #endif
+  pstat_add(PSTAT_S68K_CYCLES, SekCycleCntS68k - cyc_start);
 }
 
 static void pcd_set_cycle_mult(void)
@@ -160,6 +164,24 @@ unsigned int pcd_cycles_m68k_to_s68k(unsigned int c)
 /* events */
 static void pcd_cdc_event(unsigned int now)
 {
+  int step = 12500000/75 / CDD_FAST_MULT;
+
+  // fast drive mode: the 75Hz period is split into slots, a slot reads
+  // the next data block if the sub cpu has taken the previous one
+  if (Pico_mcd->m.cdd_subtick != 0 && (PicoOpt & POPT_EN_MCD_FASTCD)) {
+    if (cdd_reading_data() && cdc_decoder_idle())
+      cdd_update();
+
+    if (++Pico_mcd->m.cdd_subtick == CDD_FAST_MULT) {
+      // stay on the 75Hz grid
+      Pico_mcd->m.cdd_subtick = 0;
+      step = 12500000/75 - step * (CDD_FAST_MULT - 1);
+    }
+    pcd_event_schedule(now, PCD_EVENT_CDC, step);
+    return;
+  }
+  Pico_mcd->m.cdd_subtick = 0;
+
   // 75Hz CDC update
   cdd_update();
 
@@ -175,7 +197,12 @@ static void pcd_cdc_event(unsigned int now)
     }
   }
 
-  pcd_event_schedule(now, PCD_EVENT_CDC, 12500000/75);
+  if ((PicoOpt & POPT_EN_MCD_FASTCD) && cdd_reading_data()) {
+    Pico_mcd->m.cdd_subtick = 1;
+    pcd_event_schedule(now, PCD_EVENT_CDC, step);
+  }
+  else
+    pcd_event_schedule(now, PCD_EVENT_CDC, 12500000/75);
 }
 
 static void pcd_int3_timer_event(unsigned int now)
@@ -195,17 +222,18 @@ static void pcd_dma_event(unsigned int now)
   cdc_dma_update();
 }
 
-typedef void (event_cb)(unsigned int now);
-
 /* times are in s68k (12.5MHz) cycles */
 unsigned int pcd_event_times[PCD_EVENT_COUNT];
-static unsigned int event_time_next;
-static event_cb *pcd_event_cbs[PCD_EVENT_COUNT] = {
+static pico_event_cb * const pcd_event_cbs[PCD_EVENT_COUNT] = {
   pcd_cdc_event,
   pcd_int3_timer_event,
   gfx_update,
   pcd_dma_event,
 };
+static struct pico_events pcd_events = {
+  pcd_event_times, pcd_event_cbs, PCD_EVENT_COUNT, "cd", EL_CD
+};
+PICO_EVENTS_CHECK(pcd, PCD_EVENT_COUNT);
 
 void pcd_event_schedule(unsigned int now, enum pcd_event event, int after)
 {
@@ -214,17 +242,14 @@ void pcd_event_schedule(unsigned int now, enum pcd_event event, int after)
   when = now + after;
   if (when == 0) {
     // event cancelled
-    pcd_event_times[event] = 0;
+    pico_events_schedule(&pcd_events, event, 0);
     return;
   }
 
   when |= 1;
 
   elprintf(EL_CD, "cd: new event #%u %u->%u", event, now, when);
-  pcd_event_times[event] = when;
-
-  if (event_time_next == 0 || CYCLES_GT(event_time_next, when))
-    event_time_next = when;
+  pico_events_schedule(&pcd_events, event, when);
 }
 
 void pcd_event_schedule_s68k(enum pcd_event event, int after)
@@ -235,45 +260,6 @@ void pcd_event_schedule_s68k(enum pcd_event event, int after)
   pcd_event_schedule(SekCyclesDoneS68k(), event, after);
 }
 
-static void pcd_run_events(unsigned int until)
-{
-  int oldest, oldest_diff, time;
-  int i, diff;
-
-  while (1) {
-    oldest = -1, oldest_diff = 0x7fffffff;
-
-    for (i = 0; i < PCD_EVENT_COUNT; i++) {
-      if (pcd_event_times[i]) {
-        diff = pcd_event_times[i] - until;
-        if (diff < oldest_diff) {
-          oldest_diff = diff;
-          oldest = i;
-        }
-      }
-    }
-
-    if (oldest_diff <= 0) {
-      time = pcd_event_times[oldest];
-      pcd_event_times[oldest] = 0;
-      elprintf(EL_CD, "cd: run event #%d %u", oldest, time);
-      pcd_event_cbs[oldest](time);
-    }
-    else if (oldest_diff < 0x7fffffff) {
-      event_time_next = pcd_event_times[oldest];
-      break;
-    }
-    else {
-      event_time_next = 0;
-      break;
-    }
-  }
-
-  if (oldest != -1)
-    elprintf(EL_CD, "cd: next event #%d at %u",
-      oldest, event_time_next);
-}
-
 int pcd_sync_s68k(unsigned int m68k_target, int m68k_poll_sync)
 {
   #define now SekCycleCntS68k
@@ -289,19 +275,23 @@ int pcd_sync_s68k(unsigned int m68k_target, int m68k_poll_sync)
 
   if (Pico_mcd->m.busreq != 1) { /* busreq/reset */
     SekCycleCntS68k = SekCycleAimS68k = s68k_target;
-    pcd_run_events(m68k_target);
+    pico_events_run(&pcd_events, m68k_target);
     return 0;
   }
 
   while (CYCLES_GT(s68k_target, now)) {
-    if (event_time_next && CYCLES_GE(now, event_time_next))
-      pcd_run_events(now);
+    if (pcd_events.next && CYCLES_GE(now, pcd_events.next))
+      pico_events_run(&pcd_events, now);
 
     target = s68k_target;
-    if (event_time_next && CYCLES_GT(target, event_time_next))
-      target = event_time_next;
+    if (pcd_events.next && CYCLES_GT(target, pcd_events.next))
+      target = pcd_events.next;
+
+    if (Pico_mcd->m.s68k_idle_cc)
+      s68k_idle_check();
 
     SekRunS68k(target);
+    s68k_idle_detect();
     if (m68k_poll_sync && Pico_mcd->m.m68k_poll_cnt == 0)
       break;
   }
@@ -325,6 +315,7 @@ void pcd_run_cpus_normal(int m68k_cycles)
     if (s68k_left <= 0) {
       elprintf(EL_CDPOLL, "m68k poll [%02x] x%d @%06x",
         Pico_mcd->m.m68k_poll_a, Pico_mcd->m.m68k_poll_cnt, SekPc);
+      pstat_add(PSTAT_POLL_SKIPS, 1);
       SekCycleCnt = SekCycleAim;
       return;
     }
@@ -409,8 +400,8 @@ void pcd_state_loaded(void)
     Pico_mcd->pcm.update_cycles = cycles;
 
   // reschedule
-  event_time_next = 0;
-  pcd_run_events(SekCycleCntS68k);
+  pico_events_rebuild(&pcd_events);
+  pico_events_run(&pcd_events, SekCycleCntS68k);
 }
 
 // vim:shiftwidth=2:ts=2:expandtab
@@ -25,27 +25,11 @@
 .global PicoReadM68k8_cell1
 .global PicoReadM68k16_cell0
 .global PicoReadM68k16_cell1
-.global PicoWriteM68k8_cell0
-.global PicoWriteM68k8_cell1
-.global PicoWriteM68k16_cell0
-.global PicoWriteM68k16_cell1
 
 .global PicoReadS68k8_dec0
 .global PicoReadS68k8_dec1
 .global PicoReadS68k16_dec0
 .global PicoReadS68k16_dec1
-.global PicoWriteS68k8_dec_m0b0
-.global PicoWriteS68k8_dec_m1b0
-.global PicoWriteS68k8_dec_m2b0
-.global PicoWriteS68k8_dec_m0b1
-.global PicoWriteS68k8_dec_m1b1
-.global PicoWriteS68k8_dec_m2b1
-.global PicoWriteS68k16_dec_m0b0
-.global PicoWriteS68k16_dec_m1b0
-.global PicoWriteS68k16_dec_m2b0
-.global PicoWriteS68k16_dec_m0b1
-.global PicoWriteS68k16_dec_m1b1
-.global PicoWriteS68k16_dec_m2b1
 
 @ externs, just for reference
 .extern Pico
@@ -319,23 +303,6 @@ m_m68k_read16_hi:
 @ @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
 
 
-PicoWriteM68k8_cell0:                   @ 0x220000 - 0x23ffff, cell arranged
-    mov     r12,#0x0c0000
-    b       0f
-
-PicoWriteM68k8_cell1:                   @ 0x220000 - 0x23ffff, cell arranged
-    mov     r12,#0x0e0000
-0:
-    mov     r3, r1
-    cell_map
-    ldr     r2, =(Pico+0x22200)
-    add     r0, r0, r12
-    ldr     r2, [r2]
-    eor     r0, r0, #1
-    strb    r3, [r2, r0]
-    bx      lr
-
-
 PicoWrite8_mcd_io:
     and     r2, r0, #0xff00
     cmp     r2, #0x2000                 @ a120xx?
@@ -346,23 +313,6 @@ PicoWrite8_mcd_io:
 @ @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
 
 
-PicoWriteM68k16_cell0:                   @ 0x220000 - 0x23ffff, cell arranged
-    mov     r12, #0x0c0000
-    b       0f
-
-PicoWriteM68k16_cell1:                   @ 0x220000 - 0x23ffff, cell arranged
-    mov     r12, #0x0e0000
-0:
-    mov     r3, r1
-    cell_map
-    ldr     r1, =(Pico+0x22200)
-    add     r0, r0, r12
-    ldr     r1, [r1]
-    bic     r0, r0, #1
-    strh    r3, [r1, r0]
-    bx      lr
-
-
 PicoWrite16_mcd_io:
     and     r2, r0, #0xff00
     cmp     r2, #0x2000                 @ a120xx?
@@ -507,60 +457,6 @@ m_s68k_read16_regs:
 @ @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
 
 
-.macro m_s68k_write8_2M_decode
-    ldr     r2, =(Pico+0x22200)
-    eor     r0, r0, #2
-    ldr     r2, [r2]			@ Pico.rom
-    movs    r0, r0, lsr #1              @ +4-6 <<16
-    add     r2, r2, r3                  @ map to our address
-.endm
-
-PicoWriteS68k8_dec_m2b0:                @ overwrite
-    ands    r1, r1, #0x0f
-    bxeq    lr
-
-PicoWriteS68k8_dec_m0b0:
-    mov     r3, #0x080000
-    b       0f
-
-PicoWriteS68k8_dec_m2b1:                @ overwrite
-    ands    r1, r1, #0x0f
-    bxeq    lr
-
-PicoWriteS68k8_dec_m0b1:
-    mov     r3, #0x0a0000
-0:
-    m_s68k_write8_2M_decode
-    ldrb    r0, [r2, r0]!
-    and     r1, r1, #0x0f
-    movcc   r1, r1, lsl #4
-    andcc   r3, r0, #0x0f
-    andcs   r3, r0, #0xf0
-    orr     r3, r3, r1
-    strneb  r3, [r2]
-    bx      lr
-
-PicoWriteS68k8_dec_m1b0:                @ underwrite
-    mov     r3, #0x080000
-    b       0f
-
-PicoWriteS68k8_dec_m1b1:
-    mov     r3, #0x0a0000
-0:
-    ands    r1, r1, #0x0f
-    bxeq    lr
-    m_s68k_write8_2M_decode
-    ldrb    r0, [r2, r0]!
-    movcc   r1, r1, lsl #4
-    andcc   r3, r0, #0x0f
-    andcs   r3, r0, #0xf0
-    teq     r3, r0
-    bxne    lr
-    orr     r3, r3, r1
-    strneb  r3, [r2]
-    bx      lr
-
-
 PicoWriteS68k8_pr:
     and     r2, r0, #0xfe00
     cmp     r2, #0x8000
@@ -610,72 +506,6 @@ m_s68k_write8_pcm_ram:
 @ @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
 
 
-.macro m_s68k_write16_2M_decode
-    ldr     r2, =(Pico+0x22200)
-    eor     r0, r0, #2
-    ldr     r2, [r2]
-    mov     r0, r0, lsr #1              @ +4-6 <<16
-    add     r2, r2, r3                  @ map to our address
-.endm
-
-PicoWriteS68k16_dec_m0b0:
-    mov     r3, #0x080000
-    b       0f
-
-PicoWriteS68k16_dec_m0b1:
-    mov     r3, #0x0a0000
-0:
-    m_s68k_write16_2M_decode
-    bic     r1, r1, #0xf0
-    orr     r1, r1, r1, lsr #4
-    strb    r1, [r2, r0]
-    bx      lr
-
-PicoWriteS68k16_dec_m1b0:               @ underwrite
-    mov     r3, #0x080000
-    b       0f
-
-PicoWriteS68k16_dec_m1b1:
-    mov     r3, #0x0a0000
-0:
-    bics    r1, r1, #0xf000
-    bicnes  r1, r1, #0x00f0
-    bxeq    lr
-    orr     r1, r1, r1, lsr #4
-    m_s68k_write16_2M_decode
-    ldrb    r0, [r2, r0]!
-    and     r3, r1, #0x0f
-    and     r1, r1, #0xf0
-    tst     r0, #0x0f
-    orreq   r0, r0, r3
-    tst     r0, #0xf0
-    orreq   r0, r0, r1
-    strb    r0, [r2]
-    bx      lr
-
-PicoWriteS68k16_dec_m2b0:               @ overwrite
-    mov     r3, #0x080000
-    b       0f
-
-PicoWriteS68k16_dec_m2b1:
-    mov     r3, #0x0a0000
-0:
-    bics    r1, r1, #0xf000
-    bicnes  r1, r1, #0x00f0
-    bxeq    lr
-    orr     r1, r1, r1, lsr #4
-    m_s68k_write16_2M_decode
-    ldrb    r0, [r2, r0]!
-    ands    r3, r1, #0x0f
-    andne   r0, r0, #0xf0
-    orrne   r0, r0, r3
-    ands    r1, r1, #0xf0
-    andne   r0, r0, #0x0f
-    orrne   r0, r0, r1
-    strb    r0, [r2]
-    bx      lr
-
-
 PicoWriteS68k16_pr:
     and     r2, r0, #0xfe00
     cmp     r2, #0x8000
@@ -27,11 +27,12 @@
 
 
 .global wram_2M_to_1M
+@ r0=m2M, r1=m1M
 wram_2M_to_1M:
     stmfd   sp!,{r4-r11,lr}
-    add     r1, r0, #0x60000    @ m1M_b1
-    add     r0, r0, #0x40000    @ m1M_b0
-    mov     r2, r0              @ m2M
+    add     r2, r0, #0x40000    @ m2M
+    add     r0, r1, #0x20000    @ m1M_b0
+    add     r1, r1, #0x40000    @ m1M_b1
 
     mov     r11, #0xff
     orr     r11, r11, r11, lsl #8
@@ -50,30 +51,4 @@ _2Mto1M_loop:
 
     ldmfd   sp!,{r4-r11,pc}
 
-
-
-.global wram_1M_to_2M
-wram_1M_to_2M:
-    stmfd   sp!,{r4-r11,lr}
-    mov     r2, r0              @ m2M
-    add     r1, r0, #0x40000    @ m1M_b1
-    add     r0, r0, #0x20000    @ m1M_b0
-
-    mov     r11, #0xff
-    orr     r11, r11, r11, lsl #8
-    mov     r12, #(0x40000/8/4)
-
-_1Mto2M_loop:
-    ldmia   r0!,{r3,r5,r7,r9}
-    ldmia   r1!,{r4,r6,r8,lr}
-    _conv_reg r3,r4
-    _conv_reg r5,r6
-    _conv_reg r7,r8
-    _conv_reg r9,lr
-    subs    r12, r12, #1
-    stmia   r2!,{r3-r9,lr}
-    bne     _1Mto2M_loop
-
-    ldmfd   sp!,{r4-r11,pc}
-
 @ vim:filetype=armasm
@@ -49,13 +49,43 @@ unsigned int pcd_pcm_read(unsigned int a)
   return d & 0xff;
 }
 
+// fetch up to 'steps' samples of a channel, following loop points;
+// returns the number of samples produced (less if the channel stopped)
+static int pcm_chan_fetch(struct pcm_chan *ch, short *buf, int steps)
+{
+  const unsigned char *ram = Pico_mcd->pcm_ram;
+  unsigned int addr = ch->addr;
+  int inc = *(unsigned short *)&ch->regs[2];
+  int s, smp;
+
+  for (s = 0; s < steps; s++, addr = (addr + inc) & 0x7FFFFFF)
+  {
+    smp = ram[addr >> PCM_STEP_SHIFT];
+
+    // test for loop signal
+    if (smp == 0xff)
+    {
+      addr = *(unsigned short *)&ch->regs[4]; // loop_addr
+      smp = ram[addr];
+      addr <<= PCM_STEP_SHIFT;
+      if (smp == 0xff)
+        break;
+    }
+
+    buf[s] = (smp & 0x80) ? -(smp & 0x7f) : smp;
+  }
+  ch->addr = addr;
+
+  return s;
+}
+
 void pcd_pcm_sync(unsigned int to)
 {
   unsigned int cycles = Pico_mcd->pcm.update_cycles;
-  int mul_l, mul_r, inc, smp;
+  short smps[PCM_MIXBUF_LEN];
+  int mul_l, mul_r;
   struct pcm_chan *ch;
-  unsigned int addr;
-  int c, s, steps;
+  int c, s, n, steps;
   int enabled;
   int *out;
 
@@ -78,6 +108,8 @@ void pcd_pcm_sync(unsigned int to)
   Pico_mcd->pcm_mixbuf_dirty = 1;
   Pico_mcd->pcm_regs_dirty = 0;
 
+  // registers can't change within a sync (writes sync first), so each
+  // channel is rendered as one run: fetch samples, then mix them
   for (c = 0; c < 8; c++)
   {
     ch = &Pico_mcd->pcm.ch[c];
@@ -87,32 +119,18 @@ void pcd_pcm_sync(unsigned int to)
       continue; // channel disabled
     }
 
-    addr = ch->addr;
-    inc = *(unsigned short *)&ch->regs[2];
+    n = pcm_chan_fetch(ch, smps, steps);
+
     mul_l = ((int)ch->regs[0] * (ch->regs[1] & 0xf)) >> (5+1); 
     mul_r = ((int)ch->regs[0] * (ch->regs[1] >>  4)) >> (5+1);
+    if (mul_l == 0 && mul_r == 0)
+      continue;
 
-    for (s = 0; s < steps; s++, addr = (addr + inc) & 0x7FFFFFF)
+    for (s = 0; s < n; s++)
     {
-      smp = Pico_mcd->pcm_ram[addr >> PCM_STEP_SHIFT];
-
-      // test for loop signal
-      if (smp == 0xff)
-      {
-        addr = *(unsigned short *)&ch->regs[4]; // loop_addr
-        smp = Pico_mcd->pcm_ram[addr];
-        addr <<= PCM_STEP_SHIFT;
-        if (smp == 0xff)
-          break;
-      }
-
-      if (smp & 0x80)
-        smp = -(smp & 0x7f);
-
-      out[s*2  ] += smp * mul_l; // max 128 * 119 = 15232
-      out[s*2+1] += smp * mul_r;
+      out[s*2  ] += smps[s] * mul_l; // max 128 * 119 = 15232
+      out[s*2+1] += smps[s] * mul_r;
     }
-    ch->addr = addr;
   }
 
 end:
@@ -200,6 +200,7 @@ void PDebugShowPalette(unsigned short *screen, int stride)
   int x, y;
 
   Pico.m.dirtyPal = 1;
+  PicoPalDirtyAll();
   if (PicoAHW & PAHW_SMS)
     PicoDoHighPal555M4();
   else
@@ -323,14 +324,11 @@ void PDebugDumpMem(void)
   if (PicoAHW & PAHW_MCD)
   {
     dump_ram(Pico_mcd->prg_ram, "dumps/prg_ram.bin");
-    if (Pico_mcd->s68k_regs[3]&4) // 1M mode?
-      wram_1M_to_2M(Pico_mcd->word_ram2M);
     dump_ram(Pico_mcd->word_ram2M, "dumps/word_ram_2M.bin");
-    wram_2M_to_1M(Pico_mcd->word_ram2M);
+    if (!Pico_mcd->m.wram_dual) // 1M layout not maintained yet
+      wram_2M_to_1M(Pico_mcd->word_ram2M, Pico_mcd->word_ram1M[0]);
     dump_ram(Pico_mcd->word_ram1M[0], "dumps/word_ram_1M_0.bin");
     dump_ram(Pico_mcd->word_ram1M[1], "dumps/word_ram_1M_1.bin");
-    if (!(Pico_mcd->s68k_regs[3]&4)) // 2M mode?
-      wram_2M_to_1M(Pico_mcd->word_ram2M);
     dump_ram_noswab(Pico_mcd->pcm_ram,"dumps/pcm_ram.bin");
     dump_ram_noswab(Pico_mcd->bram,   "dumps/bram.bin");
   }
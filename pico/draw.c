@@ -35,17 +35,23 @@ int (*PicoScanBegin)(unsigned int num) = NULL;
 int (*PicoScanEnd)  (unsigned int num) = NULL;
 
 static unsigned char DefHighCol[8+320+8];
-unsigned char *HighCol = DefHighCol;
+PICO_DRAW_TLS unsigned char *HighCol = DefHighCol;
 static unsigned char *HighColBase = DefHighCol;
 static int HighColIncrement;
 
 static unsigned int DefOutBuff[320*2/2];
-void *DrawLineDest = DefOutBuff; // pointer to dest buffer where to draw this line to
+
+// vdp state the lines are drawn from, points to a copy
+// while the frame is drawn on the draw thread
+static unsigned short *DrawVram = Pico.vram;
+static unsigned short *DrawCram = Pico.cram;
+static unsigned short *DrawVsram = Pico.vsram;
+static struct PicoVideo *DrawVideo = &Pico.video;
+int DrawThreaded;
+PICO_DRAW_TLS void *DrawLineDest = DefOutBuff; // pointer to dest buffer where to draw this line to
 void *DrawLineDestBase = DefOutBuff;
 int DrawLineDestIncrement;
 
-static int  HighCacheA[41+1];   // caches for high layers
-static int  HighCacheB[41+1];
 int  HighPreSpr[80*2+1]; // slightly preprocessed sprites
 
 #define SPRL_HAVE_HI     0x80 // have hi priority sprites
@@ -54,12 +60,26 @@ int  HighPreSpr[80*2+1]; // slightly preprocessed sprites
 #define SPRL_LO_ABOVE_HI 0x10 // low priority sprites may be on top of hi
 unsigned char HighLnSpr[240][3 + MAX_LINE_SPRITES]; // sprite_count, ^flags, tile_count, [spritep]...
 
-int rendstatus, rendstatus_old;
+// HighLnSpr upkeep: sat entries as the lines were built from them, entries
+// that may have been written since, and lines that need to be rebuilt
+unsigned int HighSprDirty[4] = { ~0u, ~0u, ~0u, ~0u };
+static unsigned int HighSprCache[128][2];
+static unsigned int HighLnSprDirty[(240+31)/32];
+static int HighSprConfig = -1;
+
+#define LNSPR_DIRTY(y) (HighLnSprDirty[(y) >> 5] & (1u << ((y) & 31)))
+
+// vram patterns decoded to a byte per pixel, one 8 pixel row per vram long
+unsigned int HighTileValid[2048/32];
+static unsigned long long HighTileCache[0x8000/2];
+
+PICO_DRAW_TLS int rendstatus;
+int rendstatus_old;
 int rendlines;
-int DrawScanline;
+PICO_DRAW_TLS int DrawScanline;
 int PicoDrawMask = -1;
 
-static int skip_next_line=0;
+static PICO_DRAW_TLS int skip_next_line=0;
 
 //unsigned short ppt[] = { 0x0f11, 0x0ff1, 0x01f1, 0x011f, 0x01ff, 0x0f1f, 0x0f0e, 0x0e7c };
 
@@ -95,23 +115,79 @@ void blockcpy_or(void *dst, void *src, size_t n, int pat)
 #endif
 
 
+void PicoTileDirtyRange(unsigned int a, int n)
+{
+  unsigned int t, end;
+
+  if (n <= 0)
+    return;
+  if (n >= 0x8000) {
+    PicoTileDirtyAll();
+    return;
+  }
+  for (t = a >> 4, end = (a + n + 15) >> 4; t < end; t++)
+    PicoTileDirtyEntry(t << 4);
+}
+
+static NOINLINE void DecodeTile(unsigned int tile)
+{
+  unsigned int *ps = (unsigned int *)(DrawVram + (tile << 4));
+  unsigned char *pd = (unsigned char *)&HighTileCache[tile << 3];
+  unsigned int pack;
+  int i;
+
+  for (i = 0; i < 8; i++, pd += 8)
+  {
+    pack = ps[i];
+    pd[0] = (pack >> 12) & 0xf; pd[1] = (pack >>  8) & 0xf;
+    pd[2] = (pack >>  4) & 0xf; pd[3] =  pack        & 0xf;
+    pd[4] = (pack >> 28);       pd[5] = (pack >> 24) & 0xf;
+    pd[6] = (pack >> 20) & 0xf; pd[7] = (pack >> 16) & 0xf;
+  }
+  HighTileValid[tile >> 5] |= 1u << (tile & 31);
+}
+
+// get 8 pixels of the tile row at vram word address addr
+static INLINE unsigned long long TileRow(unsigned int addr)
+{
+  unsigned int tile = (addr >> 4) & 0x7ff;
+
+  if (!(HighTileValid[tile >> 5] & (1u << (tile & 31))))
+    DecodeTile(tile);
+  return HighTileCache[(addr >> 1) & 0x3fff];
+}
+
+// same, mirrored
+#if defined(__GNUC__)
+#define TileRowFlip(addr) __builtin_bswap64(TileRow(addr))
+#else
+static INLINE unsigned long long TileRowFlip(unsigned int addr)
+{
+  unsigned long long px = TileRow(addr);
+  px = (px >> 32) | (px << 32);
+  px = ((px >> 16) & 0x0000ffff0000ffffull) | ((px & 0x0000ffff0000ffffull) << 16);
+  return ((px >> 8) & 0x00ff00ff00ff00ffull) | ((px & 0x00ff00ff00ff00ffull) << 8);
+}
+#endif
+
 #define TileNormMaker(funcname,pix_func)                     \
 static int funcname(int sx,int addr,int pal)                 \
 {                                                            \
   unsigned char *pd = HighCol+sx;                            \
-  unsigned int pack=0; unsigned int t=0;                     \
+  unsigned long long px=TileRow(addr); /* Get 8 pixels */   \
+  unsigned char *ps = (unsigned char *)&px;                  \
+  unsigned int t;                                            \
                                                              \
-  pack=*(unsigned int *)(Pico.vram+addr); /* Get 8 pixels */ \
-  if (pack)                                                  \
+  if (px)                                                    \
   {                                                          \
-    t=(pack&0x0000f000)>>12; pix_func(0);                    \
-    t=(pack&0x00000f00)>> 8; pix_func(1);                    \
-    t=(pack&0x000000f0)>> 4; pix_func(2);                    \
-    t=(pack&0x0000000f)    ; pix_func(3);                    \
-    t=(pack&0xf0000000)>>28; pix_func(4);                    \
-    t=(pack&0x0f000000)>>24; pix_func(5);                    \
-    t=(pack&0x00f00000)>>20; pix_func(6);                    \
-    t=(pack&0x000f0000)>>16; pix_func(7);                    \
+    t=ps[0]; pix_func(0);                                    \
+    t=ps[1]; pix_func(1);                                    \
+    t=ps[2]; pix_func(2);                                    \
+    t=ps[3]; pix_func(3);                                    \
+    t=ps[4]; pix_func(4);                                    \
+    t=ps[5]; pix_func(5);                                    \
+    t=ps[6]; pix_func(6);                                    \
+    t=ps[7]; pix_func(7);                                    \
     return 0;                                                \
   }                                                          \
                                                              \
@@ -123,19 +199,20 @@ static int funcname(int sx,int addr,int pal)                 \
 static int funcname(int sx,int addr,int pal)                 \
 {                                                            \
   unsigned char *pd = HighCol+sx;                            \
-  unsigned int pack=0; unsigned int t=0;                     \
+  unsigned long long px=TileRow(addr); /* Get 8 pixels */   \
+  unsigned char *ps = (unsigned char *)&px;                  \
+  unsigned int t;                                            \
                                                              \
-  pack=*(unsigned int *)(Pico.vram+addr); /* Get 8 pixels */ \
-  if (pack)                                                  \
+  if (px)                                                    \
   {                                                          \
-    t=(pack&0x000f0000)>>16; pix_func(0);                    \
-    t=(pack&0x00f00000)>>20; pix_func(1);                    \
-    t=(pack&0x0f000000)>>24; pix_func(2);                    \
-    t=(pack&0xf0000000)>>28; pix_func(3);                    \
-    t=(pack&0x0000000f)    ; pix_func(4);                    \
-    t=(pack&0x000000f0)>> 4; pix_func(5);                    \
-    t=(pack&0x00000f00)>> 8; pix_func(6);                    \
-    t=(pack&0x0000f000)>>12; pix_func(7);                    \
+    t=ps[7]; pix_func(0);                                    \
+    t=ps[6]; pix_func(1);                                    \
+    t=ps[5]; pix_func(2);                                    \
+    t=ps[4]; pix_func(3);                                    \
+    t=ps[3]; pix_func(4);                                    \
+    t=ps[2]; pix_func(5);                                    \
+    t=ps[1]; pix_func(6);                                    \
+    t=ps[0]; pix_func(7);                                    \
     return 0;                                                \
   }                                                          \
                                                              \
@@ -148,11 +225,42 @@ int TileNorm(int sx,int addr,int pal);
 int TileFlip(int sx,int addr,int pal);
 #else
 
-#define pix_just_write(x) \
-  if (t) pd[x]=pal|t
+// plain tile pixels are a masked copy
+static INLINE void TileBlend(unsigned char *pd, unsigned long long px, int pal)
+{
+  unsigned long long m, t;
+
+  // 0xff in opaque pixel bytes, colors are < 0x10 so no carries between them
+  m = ((px + 0x7f7f7f7f7f7f7f7full) >> 7) & 0x0101010101010101ull;
+  m *= 0xff;
 
-TileNormMaker(TileNorm,pix_just_write)
-TileFlipMaker(TileFlip,pix_just_write)
+  px |= (unsigned long long)pal * 0x0101010101010101ull;
+  memcpy(&t, pd, 8);
+  t = (t & ~m) | (px & m);
+  memcpy(pd, &t, 8);
+}
+
+static int TileNorm(int sx,int addr,int pal)
+{
+  unsigned long long px = TileRow(addr); /* Get 8 pixels */
+
+  if (!px)
+    return 1; /* Tile blank */
+
+  TileBlend(HighCol+sx, px, pal);
+  return 0;
+}
+
+static int TileFlip(int sx,int addr,int pal)
+{
+  unsigned long long px = TileRowFlip(addr); /* Get 8 pixels */
+
+  if (!px)
+    return 1; /* Tile blank */
+
+  TileBlend(HighCol+sx, px, pal);
+  return 0;
+}
 
 #endif
 
@@ -230,7 +338,7 @@ static void DrawStrip(struct TileStrip *ts, int plane_sh, int cellskip)
   {
     int zero=0;
 
-    code=Pico.vram[ts->nametab+(tilex&ts->xmask)];
+    code=DrawVram[ts->nametab+(tilex&ts->xmask)];
     if (code==blank) continue;
     if (code>>15) { // high priority tile
       int cval = code | (dx<<16) | (ty<<25);
@@ -283,7 +391,7 @@ void DrawStripVSRam(struct TileStrip *ts, int plane_sh, int cellskip)
     //if((cell&1)==0)
     {
       int line,vscroll;
-      vscroll=Pico.vsram[(plane_sh&1)+(cell&~1)];
+      vscroll=DrawVsram[(plane_sh&1)+(cell&~1)];
 
       // Find the line in the name table
       line=(vscroll+scan)&ts->line&0xffff; // ts->line is really ymask ..
@@ -291,7 +399,7 @@ void DrawStripVSRam(struct TileStrip *ts, int plane_sh, int cellskip)
       ty=(line&7)<<1; // Y-Offset into tile
     }
 
-    code=Pico.vram[ts->nametab+nametabadd+(tilex&ts->xmask)];
+    code=DrawVram[ts->nametab+nametabadd+(tilex&ts->xmask)];
     if (code==blank) continue;
     if (code>>15) { // high priority tile
       int cval = code | (dx<<16) | (ty<<25);
@@ -341,7 +449,7 @@ void DrawStripInterlace(struct TileStrip *ts)
   {
     int zero=0;
 
-    code=Pico.vram[ts->nametab+(tilex&ts->xmask)];
+    code=DrawVram[ts->nametab+(tilex&ts->xmask)];
     if (code==blank) continue;
     if (code>>15) { // high priority tile
       int cval = (code&0xfc00) | (dx<<16) | (ty<<25);
@@ -376,7 +484,7 @@ void DrawStripInterlace(struct TileStrip *ts)
 #ifndef _ASM_DRAW_C
 static void DrawLayer(int plane_sh, int *hcache, int cellskip, int maxcells)
 {
-  struct PicoVideo *pvid=&Pico.video;
+  struct PicoVideo *pvid=DrawVideo;
   const char shift[4]={5,6,5,7}; // 32,64 or 128 sized tilemaps (2 is invalid)
   struct TileStrip ts;
   int width, height, ymask;
@@ -406,11 +514,11 @@ static void DrawLayer(int plane_sh, int *hcache, int cellskip, int maxcells)
   htab+=plane_sh&1; // A or B
 
   // Get horizontal scroll value, will be masked later
-  ts.hscroll=Pico.vram[htab&0x7fff];
+  ts.hscroll=DrawVram[htab&0x7fff];
 
   if((pvid->reg[12]&6) == 6) {
     // interlace mode 2
-    vscroll=Pico.vsram[plane_sh&1]; // Get vertical scroll value
+    vscroll=DrawVsram[plane_sh&1]; // Get vertical scroll value
 
     // Find the line in the name table
     ts.line=(vscroll+(DrawScanline<<1))&((ymask<<1)|1);
@@ -423,7 +531,7 @@ static void DrawLayer(int plane_sh, int *hcache, int cellskip, int maxcells)
     ts.line=ymask|(shift[width]<<24); // save some stuff instead of line
     DrawStripVSRam(&ts, plane_sh, cellskip);
   } else {
-    vscroll=Pico.vsram[plane_sh&1]; // Get vertical scroll value
+    vscroll=DrawVsram[plane_sh&1]; // Get vertical scroll value
 
     // Find the line in the name table
     ts.line=(vscroll+DrawScanline)&ymask;
@@ -439,7 +547,7 @@ static void DrawLayer(int plane_sh, int *hcache, int cellskip, int maxcells)
 // tstart & tend are tile pair numbers
 static void DrawWindow(int tstart, int tend, int prio, int sh) // int *hcache
 {
-  struct PicoVideo *pvid=&Pico.video;
+  struct PicoVideo *pvid=DrawVideo;
   int tilex,ty,nametab,code=0;
   int blank=-1; // The tile we know is blank
 
@@ -459,7 +567,7 @@ static void DrawWindow(int tstart, int tend, int prio, int sh) // int *hcache
 
   if (!(rendstatus & PDRAW_WND_DIFF_PRIO)) {
     // check the first tile code
-    code=Pico.vram[nametab+tilex];
+    code=DrawVram[nametab+tilex];
     // if the whole window uses same priority (what is often the case), we may be able to skip this field
     if ((code>>15) != prio) return;
   }
@@ -475,7 +583,7 @@ static void DrawWindow(int tstart, int tend, int prio, int sh) // int *hcache
       int addr=0,zero=0;
       int pal;
 
-      code=Pico.vram[nametab+tilex];
+      code=DrawVram[nametab+tilex];
       if (code==blank) continue;
       if ((code>>15) != prio) {
         rendstatus |= PDRAW_WND_DIFF_PRIO;
@@ -501,7 +609,7 @@ static void DrawWindow(int tstart, int tend, int prio, int sh) // int *hcache
       int addr=0,zero=0;
       int pal;
 
-      code=Pico.vram[nametab+tilex];
+      code=DrawVram[nametab+tilex];
       if(code==blank) continue;
       if((code>>15) != prio) {
         rendstatus |= PDRAW_WND_DIFF_PRIO;
@@ -602,36 +710,22 @@ static void DrawTilesFromCache(int *hc, int sh, int rlim)
 
 last_cut_tile:
   {
-    unsigned int t, pack=*(unsigned int *)(Pico.vram+addr); // Get 8 pixels
+    unsigned long long px; // Get 8 pixels
+    unsigned char *ps = (unsigned char *)&px;
     unsigned char *pd = HighCol+dx;
-    if (!pack) return;
-    if (code&0x0800)
-    {
-      switch (rlim-dx+8)
-      {
-        case 7: t=pack&0x00000f00; if (t) pd[6]=(unsigned char)(pal|(t>> 8)); // "break" is left out intentionally
-        case 6: t=pack&0x000000f0; if (t) pd[5]=(unsigned char)(pal|(t>> 4));
-        case 5: t=pack&0x0000000f; if (t) pd[4]=(unsigned char)(pal|(t    ));
-        case 4: t=pack&0xf0000000; if (t) pd[3]=(unsigned char)(pal|(t>>28));
-        case 3: t=pack&0x0f000000; if (t) pd[2]=(unsigned char)(pal|(t>>24));
-        case 2: t=pack&0x00f00000; if (t) pd[1]=(unsigned char)(pal|(t>>20));
-        case 1: t=pack&0x000f0000; if (t) pd[0]=(unsigned char)(pal|(t>>16));
-        default: break;
-      }
-    }
-    else
+    unsigned int t;
+    px = (code&0x0800) ? TileRowFlip(addr) : TileRow(addr);
+    if (!px) return;
+    switch (rlim-dx+8)
     {
-      switch (rlim-dx+8)
-      {
-        case 7: t=pack&0x00f00000; if (t) pd[6]=(unsigned char)(pal|(t>>20));
-        case 6: t=pack&0x0f000000; if (t) pd[5]=(unsigned char)(pal|(t>>24));
-        case 5: t=pack&0xf0000000; if (t) pd[4]=(unsigned char)(pal|(t>>28));
-        case 4: t=pack&0x0000000f; if (t) pd[3]=(unsigned char)(pal|(t    ));
-        case 3: t=pack&0x000000f0; if (t) pd[2]=(unsigned char)(pal|(t>> 4));
-        case 2: t=pack&0x00000f00; if (t) pd[1]=(unsigned char)(pal|(t>> 8));
-        case 1: t=pack&0x0000f000; if (t) pd[0]=(unsigned char)(pal|(t>>12));
-        default: break;
-      }
+      case 7: t=ps[6]; if (t) pd[6]=(unsigned char)(pal|t); // "break" is left out intentionally
+      case 6: t=ps[5]; if (t) pd[5]=(unsigned char)(pal|t);
+      case 5: t=ps[4]; if (t) pd[4]=(unsigned char)(pal|t);
+      case 4: t=ps[3]; if (t) pd[3]=(unsigned char)(pal|t);
+      case 3: t=ps[2]; if (t) pd[2]=(unsigned char)(pal|t);
+      case 2: t=ps[1]; if (t) pd[1]=(unsigned char)(pal|t);
+      case 1: t=ps[0]; if (t) pd[0]=(unsigned char)(pal|t);
+      default: break;
     }
   }
 }
@@ -737,7 +831,7 @@ static void DrawSpriteInterlace(unsigned int *sprite)
 
 static void DrawAllSpritesInterlace(int pri, int sh)
 {
-  struct PicoVideo *pvid=&Pico.video;
+  struct PicoVideo *pvid=DrawVideo;
   int i,u,table,link=0,sline=DrawScanline<<1;
   unsigned int *sprites[80]; // Sprite index
 
@@ -750,7 +844,7 @@ static void DrawAllSpritesInterlace(int pri, int sh)
     unsigned int *sprite;
     int code, sx, sy, height;
 
-    sprite=(unsigned int *)(Pico.vram+((table+(link<<2))&0x7ffc)); // Find sprite
+    sprite=(unsigned int *)(DrawVram+((table+(link<<2))&0x7ffc)); // Find sprite
 
     // get sprite info
     code = sprite[0];
@@ -860,6 +954,9 @@ static void DrawSpritesSHi(unsigned char *sprited)
 
 static void DrawSpritesHiAS(unsigned char *sprited, int sh)
 {
+  // operator sprites for the sh/hi pass, HighLnSpr lines are kept
+  // across frames and must not be modified here
+  unsigned char sh_sprited[3 + MAX_LINE_SPRITES];
   int (*fTileFunc)(int sx,int addr,int pal);
   unsigned char *p;
   int entry, cnt, sh_cnt = 0;
@@ -897,7 +994,7 @@ static void DrawSpritesHiAS(unsigned char *sprited, int sh)
       else            fTileFunc=TileNormAS_onlymark;
     }
     if (sh && pal == 0x30)
-      p[sh_cnt++] = offs / 2; // re-save for sh/hi pass
+      sh_sprited[3 + sh_cnt++] = offs / 2; // save for sh/hi pass
 
     // parse remaining sprite data
     sy=sprite[0];
@@ -941,11 +1038,58 @@ static void DrawSpritesHiAS(unsigned char *sprited, int sh)
   }
 
   /* nasty 2: sh operator pass */
-  sprited[0] = sh_cnt;
-  DrawSpritesSHi(sprited);
+  sh_sprited[0] = sh_cnt;
+  DrawSpritesSHi(sh_sprited);
 }
 
 
+static void MarkSpriteLines(unsigned int code, int max_lines)
+{
+  int y = (code&0x1ff)-0x80;
+  int y_end = y + (((code>>24)&3)+1)*8;
+
+  if (y < 0) y = 0;
+  for (; y < y_end && y < max_lines; y++)
+    HighLnSprDirty[y >> 5] |= 1u << (y & 31);
+}
+
+// compare the sat with what HighLnSpr was built from, mark affected lines
+static void UpdateSpriteLines(int table, int config, int max_lines)
+{
+  int u;
+
+  if (config != HighSprConfig) {
+    HighSprConfig = config;
+    PicoSprDirtyAll();
+    memset(HighLnSprDirty, 0xff, sizeof(HighLnSprDirty));
+  }
+
+  for (u = 0; u < 128; u++)
+  {
+    unsigned int *sprite, *cached;
+
+    if (!(HighSprDirty[u >> 5] & (1u << (u & 31))))
+      continue;
+
+    sprite=(unsigned int *)(DrawVram+((table+(u<<2))&0x7ffc));
+    cached = HighSprCache[u];
+    if (sprite[0] == cached[0] && sprite[1] == cached[1])
+      continue;
+
+    if ((sprite[0] ^ cached[0]) & 0x007f0000)
+      // link changed, sprite order may be different everywhere
+      memset(HighLnSprDirty, 0xff, sizeof(HighLnSprDirty));
+    else {
+      MarkSpriteLines(cached[0], max_lines);
+      MarkSpriteLines(sprite[0], max_lines);
+    }
+    cached[0] = sprite[0];
+    cached[1] = sprite[1];
+  }
+
+  HighSprDirty[0] = HighSprDirty[1] = HighSprDirty[2] = HighSprDirty[3] = 0;
+}
+
 // Index + 0  :    ----hhvv -lllllll -------y yyyyyyyy
 // Index + 4  :    -------x xxxxxxxx pccvhnnn nnnnnnnn
 // v
@@ -954,20 +1098,20 @@ static void DrawSpritesHiAS(unsigned char *sprited, int sh)
 
 void PrepareSprites(int full)
 {
-  struct PicoVideo *pvid=&Pico.video;
+  struct PicoVideo *pvid=DrawVideo;
   int u,link=0,sh;
   int table=0;
   int *pd = HighPreSpr;
   int max_lines = 224, max_sprites = 80, max_width = 328;
   int max_line_sprites = 20; // 20 sprites, 40 tiles
 
-  if (!(Pico.video.reg[12]&1))
+  if (!(DrawVideo->reg[12]&1))
     max_sprites = 64, max_line_sprites = 16, max_width = 264;
   if (PicoOpt & POPT_DIS_SPRITE_LIM)
     max_line_sprites = MAX_LINE_SPRITES;
 
   if (pvid->reg[1]&8) max_lines = 240;
-  sh = Pico.video.reg[0xC]&8; // shadow/hilight?
+  sh = DrawVideo->reg[0xC]&8; // shadow/hilight?
 
   table=pvid->reg[5]&0x7f;
   if (pvid->reg[12]&1) table&=0x7e; // Lowest bit 0 in 40-cell mode
@@ -982,7 +1126,7 @@ void PrepareSprites(int full)
       unsigned int *sprite;
       int code2, sx, sy, height;
 
-      sprite=(unsigned int *)(Pico.vram+((table+(link<<2))&0x7ffc)); // Find sprite
+      sprite=(unsigned int *)(DrawVram+((table+(link<<2))&0x7ffc)); // Find sprite
 
       // parse sprite info
       code2 = sprite[1];
@@ -1023,18 +1167,31 @@ found:;
       link=(sprite[0]>>16)&0x7f;
       if (!link) break; // End of sprites
     }
+    HighSprConfig = -1; // lines were built from a mix of tables
   }
   else
   {
-    for (u = 0; u < max_lines; u++)
-      *((int *)&HighLnSpr[u][0]) = 0;
+    // only rebuild the lines where something changed,
+    // lines above the current one are left for the next frame
+    UpdateSpriteLines(table, table | (max_lines << 16) | (max_line_sprites << 24)
+      | ((pvid->reg[12]&1) << 29) | (sh << 28), max_lines);
+
+    for (u = DrawScanline; u < max_lines; u++)
+      if (LNSPR_DIRTY(u))
+        break;
+    if (u >= max_lines)
+      return; // sprite lines are up to date
+
+    for (; u < max_lines; u++)
+      if (LNSPR_DIRTY(u))
+        *((int *)&HighLnSpr[u][0]) = 0;
 
     for (u = 0; u < max_sprites; u++)
     {
       unsigned int *sprite;
       int code, code2, sx, sy, hv, height, width;
 
-      sprite=(unsigned int *)(Pico.vram+((table+(link<<2))&0x7ffc)); // Find sprite
+      sprite=(unsigned int *)(DrawVram+((table+(link<<2))&0x7ffc)); // Find sprite
 
       // parse sprite info
       code = sprite[0];
@@ -1062,6 +1219,7 @@ found:;
         {
 	  unsigned char *p = &HighLnSpr[y][0];
           int cnt = p[0];
+          if (!LNSPR_DIRTY(y)) continue;                      // unchanged line
           if (cnt >= max_line_sprites) continue;              // sprite limit?
 
           if (p[2] >= max_line_sprites*2) {        // tile limit?
@@ -1096,6 +1254,9 @@ found:;
     }
     *pd = 0;
 
+    for (u = DrawScanline; u < max_lines; u++)
+      HighLnSprDirty[u >> 5] &= ~(1u << (u & 31));
+
 #if 0
     for (u = 0; u < max_lines; u++)
     {
@@ -1157,8 +1318,13 @@ void BackFill(int reg7, int sh)
 // --------------------------------------------
 
 unsigned short HighPal[0x100];
+unsigned int HighPalDirty[2] = { ~0u, ~0u };
 
 #ifndef _ASM_DRAW_C
+static int HighPalSh = -1;
+
+// only entries written since the last call are converted,
+// the s/h variants are kept up to date along with them
 void PicoDoHighPal555(int sh)
 {
   unsigned int *spal, *dpal;
@@ -1166,10 +1332,19 @@ void PicoDoHighPal555(int sh)
 
   Pico.m.dirtyPal = 0;
 
-  spal = (void *)Pico.cram;
+  if (sh != HighPalSh) {
+    HighPalSh = sh;
+    PicoPalDirtyAll();
+  }
+  if (!(HighPalDirty[0] | HighPalDirty[1]))
+    return;
+
+  spal = (void *)DrawCram;
   dpal = (void *)HighPal;
 
   for (i = 0; i < 0x40 / 2; i++) {
+    if (!((HighPalDirty[i >> 4] >> (i & 15) * 2) & 3))
+      continue;
     t = spal[i];
 #ifdef USE_BGR555
     t = ((t & 0x000e000e)<< 1) | ((t & 0x00e000e0)<<3) | ((t & 0x0e000e00)<<4);
@@ -1180,21 +1355,18 @@ void PicoDoHighPal555(int sh)
     // otherwise intensity difference between this and s/h will be wrong
     t |= (t >> 4) & 0x08610861; // 0x18e318e3
     dpal[i] = t;
-  }
 
-  // norm: xxx0, sh: 0xxx, hi: 0xxx + 7
-  if (sh)
-  {
-    // shadowed pixels
-    for (i = 0; i < 0x40 / 2; i++)
-      dpal[0x40/2 | i] = dpal[0xc0/2 | i] = (dpal[i] >> 1) & 0x738e738e;
-    // hilighted pixels
-    for (i = 0; i < 0x40 / 2; i++) {
-      t = ((dpal[i] >> 1) & 0x738e738e) + 0x738e738e; // 0x7bef7bef;
+    // norm: xxx0, sh: 0xxx, hi: 0xxx + 7
+    if (sh) {
+      // shadowed pixels
+      dpal[0x40/2 | i] = dpal[0xc0/2 | i] = (t >> 1) & 0x738e738e;
+      // hilighted pixels
+      t = ((t >> 1) & 0x738e738e) + 0x738e738e; // 0x7bef7bef;
       t |= (t >> 4) & 0x08610861;
       dpal[0x80/2 | i] = t;
     }
   }
+  HighPalDirty[0] = HighPalDirty[1] = 0;
 }
 
 #if 0
@@ -1202,10 +1374,10 @@ static void FinalizeLineBGR444(int sh, int line)
 {
   unsigned short *pd=DrawLineDest;
   unsigned char  *ps=HighCol+8;
-  unsigned short *pal=Pico.cram;
+  unsigned short *pal=DrawCram;
   int len, i, t, mask=0xff;
 
-  if (Pico.video.reg[12]&1) {
+  if (DrawVideo->reg[12]&1) {
     len = 320;
   } else {
     if(!(PicoOpt&POPT_DIS_32C_BORDER)) pd+=32;
@@ -1215,7 +1387,7 @@ static void FinalizeLineBGR444(int sh, int line)
   if(sh) {
     pal=HighPal;
     if(Pico.m.dirtyPal) {
-      blockcpy(pal, Pico.cram, 0x40*2);
+      blockcpy(pal, DrawCram, 0x40*2);
       // shadowed pixels
       for(i = 0x3f; i >= 0; i--)
         pal[0x40|i] = pal[0xc0|i] = (unsigned short)((pal[i]>>1)&0x0777);
@@ -1247,7 +1419,7 @@ void FinalizeLine555(int sh, int line)
   if (Pico.m.dirtyPal)
     PicoDoHighPal555(sh);
 
-  if (Pico.video.reg[12]&1) {
+  if (DrawVideo->reg[12]&1) {
     len = 320;
   } else {
     if (!(PicoOpt&POPT_DIS_32C_BORDER)) pd+=32;
@@ -1288,13 +1460,15 @@ static void FinalizeLine8bit(int sh, int line)
     rs |= PDRAW_SONIC_MODE;
     rendstatus = rs;
     if (dirty_count == 3) {
-      blockcpy(HighPal, Pico.cram, 0x40*2);
+      blockcpy(HighPal, DrawCram, 0x40*2);
+      PicoPalDirtyAll();
     } else if (dirty_count == 11) {
-      blockcpy(HighPal+0x40, Pico.cram, 0x40*2);
+      blockcpy(HighPal+0x40, DrawCram, 0x40*2);
+      PicoPalDirtyAll();
     }
   }
 
-  if (Pico.video.reg[12]&1) {
+  if (DrawVideo->reg[12]&1) {
     len = 320;
   } else {
     if (!(PicoOpt & POPT_DIS_32C_BORDER))
@@ -1320,10 +1494,12 @@ static void (*FinalizeLine)(int sh, int line);
 static int DrawDisplay(int sh)
 {
   unsigned char *sprited = &HighLnSpr[DrawScanline][0];
-  struct PicoVideo *pvid=&Pico.video;
+  struct PicoVideo *pvid=DrawVideo;
+  int HighCacheA[41+1], HighCacheB[41+1]; // caches for high layers
   int win=0,edge=0,hvwind=0;
   int maxw,maxcells;
 
+  HighCacheA[0] = HighCacheB[0] = 0;
   rendstatus &= ~(PDRAW_SHHI_DONE|PDRAW_PLANE_HI_PRIO);
 
   if (pvid->reg[12]&1) {
@@ -1482,7 +1658,7 @@ static void PicoLine(int line, int offs, int sh, int bgc)
 
   // Draw screen:
   BackFill(bgc, sh);
-  if (Pico.video.reg[1]&0x40)
+  if (DrawVideo->reg[1]&0x40)
     DrawDisplay(sh);
 
   if (FinalizeLine != NULL)
@@ -1495,11 +1671,11 @@ static void PicoLine(int line, int offs, int sh, int bgc)
   DrawLineDest = (char *)DrawLineDest + DrawLineDestIncrement;
 }
 
-void PicoDrawSync(int to, int blank_last_line)
+static void DrawSyncLines(int to, int blank_last_line)
 {
   int line, offs = 0;
-  int sh = (Pico.video.reg[0xC] & 8) >> 3; // shadow/hilight?
-  int bgc = Pico.video.reg[7];
+  int sh = (DrawVideo->reg[0xC] & 8) >> 3; // shadow/hilight?
+  int bgc = DrawVideo->reg[7];
 
   pprof_start(draw);
 
@@ -1524,6 +1700,424 @@ void PicoDrawSync(int to, int blank_last_line)
   pprof_end(draw);
 }
 
+/* threaded drawing
+ * While a frame is drawn on the draw thread, vdp writes are logged along
+ * with the points where the lines were to be drawn (PicoDrawSync calls),
+ * and the log is replayed in batches on the thread against a copy of the
+ * vdp state, taken at the start of the frame. Writes only set the render
+ * flags (dirty palette, sprites) from the replay then.
+ */
+#define DRAW_LOG_ENTRIES   0x1000
+#define DRAW_LOG_DATA      0x8000 // words, whole vram
+#define DRAW_BATCH_LINES   16
+
+struct draw_log_entry {
+  unsigned short type;
+  unsigned short a;
+  unsigned int n;
+};
+
+struct draw_log {
+  int cnt, data_cnt;
+  struct draw_log_entry e[DRAW_LOG_ENTRIES];
+  unsigned short data[DRAW_LOG_DATA];
+};
+
+static struct {
+  unsigned short vram[0x8000];
+  unsigned short cram[0x40];
+  unsigned short vsram[0x40];
+  struct PicoVideo video;
+} DrawVdp;
+
+// line drawing state as one thread left it for another
+struct draw_state {
+  unsigned char *HighCol;
+  void *DrawLineDest;
+  int DrawScanline;
+  int skip_next_line;
+  int rendstatus;
+};
+
+static struct pico_thread *draw_thread;
+static int draw_thread_failed;
+static struct draw_log *draw_log[2];
+static int draw_log_cur, draw_log_kicked;
+static int draw_log_line, draw_log_kick_line;
+static struct draw_state DrawThreadState;
+
+static void DrawStateSave(struct draw_state *st)
+{
+  st->HighCol = HighCol;
+  st->DrawLineDest = DrawLineDest;
+  st->DrawScanline = DrawScanline;
+  st->skip_next_line = skip_next_line;
+  st->rendstatus = rendstatus;
+}
+
+static void DrawStateLoad(const struct draw_state *st)
+{
+  HighCol = st->HighCol;
+  DrawLineDest = st->DrawLineDest;
+  DrawScanline = st->DrawScanline;
+  skip_next_line = st->skip_next_line;
+  rendstatus = st->rendstatus;
+}
+
+static void DrawLogReplay(void *arg)
+{
+  struct draw_log *log = arg;
+  unsigned short *data = log->data;
+  unsigned int a, sat;
+  int i, n;
+
+  DrawStateLoad(&DrawThreadState);
+  for (i = 0; i < log->cnt; i++)
+  {
+    struct draw_log_entry *e = &log->e[i];
+    a = e->a;
+    n = e->n;
+    switch (e->type)
+    {
+      case DLOG_DRAW:
+        DrawSyncLines(a, n);
+        break;
+
+      case DLOG_VRAM:
+        if (n == 1) {
+          sat = (DrawVideo->reg[5]&0x7f) << 8;
+          if (DrawVideo->reg[12]&1) sat &= ~0x100; // 40 cell mode
+          if (((a - sat) & 0x7fff) < 0x200) {
+            PicoSprDirtyEntry(((a - sat) & 0x7fff) >> 2);
+            rendstatus |= PDRAW_DIRTY_SPRITES;
+          }
+        }
+        else {
+          PicoSprDirtyAll();
+          rendstatus |= PDRAW_DIRTY_SPRITES;
+        }
+        PicoTileDirtyRange(a, n);
+        for (; n > 0; n--, a++)
+          DrawVram[a & 0x7fff] = *data++;
+        break;
+
+      case DLOG_CRAM:
+        Pico.m.dirtyPal = 1;
+        for (; n > 0; n--, a++, data++) {
+          if (DrawCram[a & 0x3f] != *data)
+            PicoPalDirtyEntry(a & 0x3f);
+          DrawCram[a & 0x3f] = *data;
+        }
+        break;
+
+      case DLOG_VSRAM:
+        for (; n > 0; n--, a++)
+          DrawVsram[a & 0x3f] = *data++;
+        break;
+
+      case DLOG_REG:
+        if (a == 5 && DrawVideo->reg[5] != n)
+          rendstatus |= PDRAW_SPRITES_MOVED;
+        if (a == 12 && ((DrawVideo->reg[12] ^ n) & 8))
+          Pico.m.dirtyPal = 2;
+        DrawVideo->reg[a] = n;
+        break;
+    }
+  }
+  DrawStateSave(&DrawThreadState);
+}
+
+// hand the current log over to the thread once it's done with the other one
+static void DrawLogKick(void)
+{
+  struct draw_log *log = draw_log[draw_log_cur];
+
+  pico_thread_wait(draw_thread);
+  draw_log_cur ^= 1;
+  draw_log[draw_log_cur]->cnt = draw_log[draw_log_cur]->data_cnt = 0;
+  if (log->cnt > 0) {
+    pico_thread_run(draw_thread, DrawLogReplay, log);
+    draw_log_kicked = 1;
+  }
+}
+
+// log n words of vram/cram/vsram from a, or a register write
+void PicoDrawLog(int type, unsigned int a, unsigned int n)
+{
+  struct draw_log *log = draw_log[draw_log_cur];
+  struct draw_log_entry *e;
+  unsigned short *src = NULL;
+  unsigned int mask = 0;
+
+  switch (type) {
+    case DLOG_VRAM:  src = Pico.vram;  mask = 0x7fff; break;
+    case DLOG_CRAM:  src = Pico.cram;  mask = 0x3f; break;
+    case DLOG_VSRAM: src = Pico.vsram; mask = 0x3f; break;
+  }
+  if (n > mask + 1)
+    n = mask + 1;
+
+  if (log->cnt >= DRAW_LOG_ENTRIES || (src && log->data_cnt + n > DRAW_LOG_DATA)) {
+    DrawLogKick();
+    log = draw_log[draw_log_cur];
+  }
+
+  e = &log->e[log->cnt++];
+  e->type = type;
+  e->a = a;
+  e->n = n;
+  if (type == DLOG_REG)
+    e->n = Pico.video.reg[a];
+  else if (src != NULL) {
+    unsigned short *d = log->data + log->data_cnt;
+    log->data_cnt += n;
+    for (; n > 0; n--, a++)
+      *d++ = src[a & mask];
+  }
+
+  if (type == DLOG_DRAW && (int)a >= draw_log_kick_line) {
+    draw_log_kick_line = a + DRAW_BATCH_LINES;
+    DrawLogKick();
+  }
+}
+
+void PicoDrawSync(int to, int blank_last_line)
+{
+  if (DrawThreaded) {
+    if (to >= draw_log_line) {
+      draw_log_line = to + 1;
+      PicoDrawLog(DLOG_DRAW, to, blank_last_line);
+    }
+    return;
+  }
+
+  DrawSyncLines(to, blank_last_line);
+}
+
+static int DrawThreadOk(void)
+{
+  if (!(PicoOpt & (POPT_EN_DRAW_THREAD|POPT_EN_DRAW_BANDS)) || draw_thread_failed)
+    return 0;
+#ifdef _ASM_DRAW_C
+  // asm parts use Pico.vram and friends directly
+  return 0;
+#endif
+  if ((PicoOpt & POPT_ALT_RENDERER) || (PicoAHW & (PAHW_32X|PAHW_SMS)))
+    return 0;
+
+  if (draw_thread == NULL) {
+    draw_log[0] = malloc(sizeof(*draw_log[0]));
+    draw_log[1] = malloc(sizeof(*draw_log[1]));
+    if (draw_log[0] != NULL && draw_log[1] != NULL)
+      draw_thread = pico_thread_create();
+    if (draw_thread == NULL) {
+      elprintf(EL_STATUS, "no draw thread, drawing inline");
+      free(draw_log[0]);
+      free(draw_log[1]);
+      draw_log[0] = draw_log[1] = NULL;
+      draw_thread_failed = 1;
+      return 0;
+    }
+  }
+
+  return 1;
+}
+
+// called by PicoFrameHints() after PicoFrameStart() for frames to be drawn
+void PicoDrawThreadFrameStart(void)
+{
+  if (!DrawThreadOk())
+    return;
+
+  memcpy(DrawVdp.vram, Pico.vram, sizeof(DrawVdp.vram));
+  memcpy(DrawVdp.cram, Pico.cram, sizeof(DrawVdp.cram));
+  memcpy(DrawVdp.vsram, Pico.vsram, sizeof(DrawVdp.vsram));
+  DrawVdp.video = Pico.video;
+  DrawVram = DrawVdp.vram;
+  DrawCram = DrawVdp.cram;
+  DrawVsram = DrawVdp.vsram;
+  DrawVideo = &DrawVdp.video;
+
+  draw_log_cur = 0;
+  draw_log[0]->cnt = draw_log[0]->data_cnt = 0;
+  draw_log_kicked = 0;
+  draw_log_line = DrawScanline;
+  draw_log_kick_line = DrawScanline + DRAW_BATCH_LINES;
+  if (PicoOpt & POPT_EN_DRAW_BANDS)
+    draw_log_kick_line = 0x7fffffff; // all lines at frame end
+  DrawStateSave(&DrawThreadState);
+  DrawThreaded = 1;
+}
+
+/* band drawing
+ * If nothing but the line positions was logged over the frame, all lines
+ * are drawn from the same vdp state, so they can be drawn out of order.
+ * At frame end the lines are split in bands, each drawn by a helper
+ * thread (and the caller) with its own line state and line buffer.
+ */
+#ifdef PICO_DRAW_MT
+
+#define DRAW_BANDS 4
+
+struct draw_band {
+  struct draw_state st;
+  int to;
+};
+
+static struct pico_thread *draw_band_thread[DRAW_BANDS - 1];
+static int draw_bands; // including the caller, 0 if not set up yet
+static unsigned char DrawBandCol[DRAW_BANDS][8+320+8];
+
+static void DrawBand(void *arg)
+{
+  struct draw_band *b = arg;
+
+  DrawStateLoad(&b->st);
+  DrawSyncLines(b->to, 0);
+  DrawStateSave(&b->st);
+}
+
+// returns the last line to draw, or -1 if the frame can't be drawn in bands
+static int DrawBandsOk(void)
+{
+  struct draw_log *log = draw_log[draw_log_cur];
+  int i;
+
+  if (!(PicoOpt & POPT_EN_DRAW_BANDS) || draw_log_kicked || log->cnt == 0)
+    return -1;
+  // line callbacks may skip lines, 8bit output tracks mid-frame palettes
+  if (PicoScanBegin != NULL || PicoScanEnd != NULL || FinalizeLine == FinalizeLine8bit)
+    return -1;
+  if (DrawThreadState.rendstatus & (PDRAW_SPRITES_MOVED|PDRAW_DIRTY_SPRITES))
+    return -1;
+  for (i = 0; i < log->cnt; i++)
+    if (log->e[i].type != DLOG_DRAW || log->e[i].n != 0)
+      return -1;
+  if ((int)log->e[log->cnt - 1].a < DrawThreadState.DrawScanline)
+    return -1;
+
+  if (draw_bands == 0) {
+    for (i = 0; i < DRAW_BANDS - 1; i++)
+      if ((draw_band_thread[i] = pico_thread_create()) == NULL)
+        break;
+    draw_bands = i + 1;
+  }
+  if (draw_bands < 2)
+    return -1;
+
+  return log->e[log->cnt - 1].a;
+}
+
+static void DrawFrameBands(int last)
+{
+  struct draw_band band[DRAW_BANDS];
+  struct draw_state *st = &DrawThreadState;
+  int first = st->DrawScanline, lines = last + 1 - first;
+  int i, n, y, w;
+
+  // make everything shared between the lines ready beforehand
+  for (i = 0; i < 2048/32; i++) {
+    if (HighTileValid[i] == ~0u)
+      continue;
+    for (w = 0; w < 32; w++)
+      if (!(HighTileValid[i] & (1u << w)))
+        DecodeTile(i * 32 + w);
+  }
+  if (Pico.m.dirtyPal && FinalizeLine != NULL)
+    PicoDoHighPal555((DrawVideo->reg[0xC] & 8) >> 3);
+
+  for (i = 0, y = first; i < draw_bands; i++, y += n)
+  {
+    n = first + lines * (i + 1) / draw_bands - y;
+    band[i].st = *st;
+    band[i].st.DrawScanline = y;
+    band[i].st.DrawLineDest = (char *)st->DrawLineDest + (y - first) * DrawLineDestIncrement;
+    if (HighColIncrement)
+      band[i].st.HighCol = st->HighCol + (y - first) * HighColIncrement;
+    else
+      band[i].st.HighCol = DrawBandCol[i];
+    // the window priority shortcut depends on lines drawn before
+    band[i].st.rendstatus |= PDRAW_WND_DIFF_PRIO;
+    band[i].to = y + n - 1;
+  }
+
+  for (i = 1; i < draw_bands; i++)
+    pico_thread_run(draw_band_thread[i - 1], DrawBand, &band[i]);
+  DrawBand(&band[0]);
+  for (i = 1; i < draw_bands; i++)
+    pico_thread_wait(draw_band_thread[i - 1]);
+
+  // continue as if the lines were drawn in order
+  for (i = 0; i < draw_bands; i++)
+    st->rendstatus |= band[i].st.rendstatus;
+  st->DrawScanline = last + 1;
+  st->DrawLineDest = (char *)st->DrawLineDest + lines * DrawLineDestIncrement;
+  st->HighCol += lines * HighColIncrement;
+}
+
+static void DrawBandsExit(void)
+{
+  int i;
+
+  for (i = 0; i < draw_bands - 1; i++) {
+    pico_thread_destroy(draw_band_thread[i]);
+    draw_band_thread[i] = NULL;
+  }
+  draw_bands = 0;
+}
+
+#else
+
+static int DrawBandsOk(void)
+{
+  return -1;
+}
+
+static void DrawFrameBands(int last)
+{
+}
+
+static void DrawBandsExit(void)
+{
+}
+
+#endif
+
+// wait for all lines of the frame, back to drawing from the live state
+void PicoDrawThreadFrameEnd(void)
+{
+  int last;
+
+  if (!DrawThreaded)
+    return;
+
+  last = DrawBandsOk();
+  if (last >= 0)
+    DrawFrameBands(last);
+  else {
+    DrawLogKick();
+    pico_thread_wait(draw_thread);
+  }
+  DrawThreaded = 0;
+  DrawStateLoad(&DrawThreadState);
+
+  DrawVram = Pico.vram;
+  DrawCram = Pico.cram;
+  DrawVsram = Pico.vsram;
+  DrawVideo = &Pico.video;
+}
+
+void PicoDrawThreadExit(void)
+{
+  DrawBandsExit();
+  pico_thread_destroy(draw_thread);
+  draw_thread = NULL;
+  free(draw_log[0]);
+  free(draw_log[1]);
+  draw_log[0] = draw_log[1] = NULL;
+  draw_thread_failed = 0;
+}
+
 // also works for fast renderer
 void PicoDrawUpdateHighPal(void)
 {
@@ -1536,9 +2130,16 @@ void PicoDrawUpdateHighPal(void)
     // FIXME?
     memcpy(HighPal + 0x40, HighPal, 0x40*2);
     memcpy(HighPal + 0x80, HighPal, 0x40*2);
+    PicoPalDirtyAll();
   }
 }
 
+// drop the kept sprite line lists, the next frame builds them from scratch
+void PicoDrawInvalidateSprites(void)
+{
+  HighSprConfig = -1;
+}
+
 void PicoDrawSetOutFormat(pdso_t which, int use_32x_line_mode)
 {
   switch (which)
@@ -0,0 +1,134 @@
+/*
+ * PicoDrive
+ *
+ * This work is licensed under the terms of MAME license.
+ * See COPYING file in the top-level directory.
+ *
+ * Event queue for the add-on hardware.
+ * Each queue has its own time base, events are kept in a binary heap
+ * ordered by due time, so finding the next one is a lookup and
+ * scheduling/cancelling is O(log n). A zeroed queue is empty, so queues
+ * can be static. times[] of every queue is part of the savestates, call
+ * pico_events_rebuild() after it's been restored.
+ */
+#include "pico_int.h"
+
+// is event a due before event b? ties go to the lower id
+static int ev_before(const struct pico_events *ev, int a, int b)
+{
+  int diff = ev->times[a] - ev->times[b];
+  return diff < 0 || (diff == 0 && a < b);
+}
+
+static void ev_set(struct pico_events *ev, int i, int id)
+{
+  ev->heap[i] = id;
+  ev->pos[id] = i + 1;
+}
+
+static void ev_sift_up(struct pico_events *ev, int i)
+{
+  int id = ev->heap[i];
+
+  while (i > 0 && ev_before(ev, id, ev->heap[(i - 1) / 2])) {
+    ev_set(ev, i, ev->heap[(i - 1) / 2]);
+    i = (i - 1) / 2;
+  }
+  ev_set(ev, i, id);
+}
+
+static void ev_sift_down(struct pico_events *ev, int i)
+{
+  int id = ev->heap[i];
+  int c;
+
+  while ((c = i * 2 + 1) < ev->len) {
+    if (c + 1 < ev->len && ev_before(ev, ev->heap[c + 1], ev->heap[c]))
+      c++;
+    if (!ev_before(ev, ev->heap[c], id))
+      break;
+    ev_set(ev, i, ev->heap[c]);
+    i = c;
+  }
+  ev_set(ev, i, id);
+}
+
+static void ev_remove(struct pico_events *ev, int id)
+{
+  int i = ev->pos[id] - 1;
+
+  ev->pos[id] = 0;
+  if (--ev->len == i)
+    return;
+
+  ev_set(ev, i, ev->heap[ev->len]);
+  ev_sift_up(ev, i);
+  ev_sift_down(ev, i);
+}
+
+static void ev_update_next(struct pico_events *ev)
+{
+  ev->next = ev->len ? ev->times[ev->heap[0]] : 0;
+}
+
+void pico_events_rebuild(struct pico_events *ev)
+{
+  int i;
+
+  ev->len = 0;
+  for (i = 0; i < ev->count; i++) {
+    ev->pos[i] = 0;
+    if (ev->times[i]) {
+      ev_set(ev, ev->len, i);
+      ev_sift_up(ev, ev->len++);
+    }
+  }
+  ev_update_next(ev);
+}
+
+// schedule event at time 'when', 0 cancels it
+void pico_events_schedule(struct pico_events *ev, int event, unsigned int when)
+{
+  int i = ev->pos[event] - 1;
+
+  ev->times[event] = when;
+  if (when == 0) {
+    if (i >= 0)
+      ev_remove(ev, event);
+  }
+  else if (i < 0) {
+    ev_set(ev, ev->len, event);
+    ev_sift_up(ev, ev->len++);
+  }
+  else {
+    ev_sift_up(ev, i);
+    ev_sift_down(ev, i);
+  }
+  ev_update_next(ev);
+}
+
+// run all events due at 'until', oldest first
+void pico_events_run(struct pico_events *ev, unsigned int until)
+{
+  unsigned int time;
+  int id;
+
+  while (ev->len > 0) {
+    id = ev->heap[0];
+    time = ev->times[id];
+    if ((int)(time - until) > 0)
+      break;
+
+    ev->times[id] = 0;
+    ev_remove(ev, id);
+    ev_update_next(ev);
+    elprintf(ev->el_mask, "%s: run event #%d %u", ev->name, id, time);
+    ev->cbs[id](time);
+  }
+
+  if (ev->len > 0)
+    elprintf(ev->el_mask, "%s: next event #%d at %u",
+      ev->name, ev->heap[0], ev->next);
+}
+
+// vim:shiftwidth=2:ts=2:expandtab
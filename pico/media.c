@@ -305,7 +305,7 @@ enum media_type_e PicoLoadMedia(const char *filename,
 
 out:
   if (rom_data)
-    free(rom_data);
+    PicoCartFree(rom_data);
   return media_type;
 }
 
@@ -791,6 +791,13 @@ PICO_INTERNAL void PicoMemSetup(void)
   PicoCpuFM68k.write_byte = m68k_write8;
   PicoCpuFM68k.write_word = m68k_write16;
   PicoCpuFM68k.write_long = m68k_write32;
+#if FAMEC_MAP_SHIFT != M68K_MEM_SHIFT
+#error FAMEC_MAP_SHIFT mismatch
+#endif
+  PicoCpuFM68k.read8_map   = m68k_read8_map;
+  PicoCpuFM68k.read16_map  = m68k_read16_map;
+  PicoCpuFM68k.write8_map  = m68k_write8_map;
+  PicoCpuFM68k.write16_map = m68k_write16_map;
 
   // setup FAME fetchmap
   {
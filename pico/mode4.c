@@ -19,96 +19,128 @@ static void (*FinalizeLineM4)(int line);
 static int skip_next_line;
 static int screen_offset;
 
-#define PLANAR_PIXEL(x,p) \
-  t = pack & (0x80808080 >> p); \
-  if (t) { \
-    t = ((t >> (7-p)) | (t >> (14-p)) | (t >> (21-p)) | (t >> (28-p))) & 0x0f; \
-    pd[x] = pal|t; \
-  }
+// planar to chunky: each table entry expands one bitplane byte to
+// 8 pixel bytes of 0/1, so a tile row decodes to 8 pixels with a few
+// 64bit ops; leftmost pixel is in the first byte, regardless of endianness
+static unsigned char planar_lut[2][256][8]; // normal, h-flipped
+static int planar_lut_done;
 
-static int TileNormM4(int sx, int addr, int pal)
+static void init_planar_lut(void)
 {
-  unsigned char *pd = HighCol + sx;
-  unsigned int pack, t;
+  int i, x;
 
-  pack = *(unsigned int *)(Pico.vram + addr); /* Get 4 bitplanes / 8 pixels */
-  if (pack)
-  {
-    PLANAR_PIXEL(0, 0)
-    PLANAR_PIXEL(1, 1)
-    PLANAR_PIXEL(2, 2)
-    PLANAR_PIXEL(3, 3)
-    PLANAR_PIXEL(4, 4)
-    PLANAR_PIXEL(5, 5)
-    PLANAR_PIXEL(6, 6)
-    PLANAR_PIXEL(7, 7)
-    return 0;
+  for (i = 0; i < 256; i++) {
+    for (x = 0; x < 8; x++) {
+      planar_lut[0][i][x] = (i >> (7 - x)) & 1;
+      planar_lut[1][i][x] = (i >> x) & 1;
+    }
   }
-
-  return 1; /* Tile blank */
+  planar_lut_done = 1;
 }
 
-static int TileFlipM4(int sx,int addr,int pal)
+static int TileM4(int sx, int addr, int pal, int flip)
 {
+  unsigned char (*lut)[8] = planar_lut[flip];
   unsigned char *pd = HighCol + sx;
-  unsigned int pack, t;
+  unsigned long long px, m, t;
+  unsigned int pack;
 
   pack = *(unsigned int *)(Pico.vram + addr); /* Get 4 bitplanes / 8 pixels */
-  if (pack)
+  if (!pack)
+    return 1; /* Tile blank */
+
+  memcpy(&px, lut[pack & 0xff], 8);
+  memcpy(&t, lut[(pack >> 8) & 0xff], 8);
+  px |= t << 1;
+  memcpy(&t, lut[(pack >> 16) & 0xff], 8);
+  px |= t << 2;
+  memcpy(&t, lut[pack >> 24], 8);
+  px |= t << 3;
+
+  // opaque pixels
+  pack |= pack >> 16;
+  pack |= pack >> 8;
+  memcpy(&m, lut[pack & 0xff], 8);
+  m *= 0xff;
+
+  px |= (unsigned long long)pal * 0x0101010101010101ull;
+  memcpy(&t, pd, 8);
+  t = (t & ~m) | (px & m);
+  memcpy(pd, &t, 8);
+
+  return 0;
+}
+
+#define TileNormM4(sx, addr, pal) TileM4(sx, addr, pal, 0)
+#define TileFlipM4(sx, addr, pal) TileM4(sx, addr, pal, 1)
+
+// sprites on each line, rebuilt when the y table or sprite size changes
+static unsigned char sprite_lines[256][1 + 8];
+static int sprite_lines_reg1, sprite_lines_reg5;
+int mode4_sat_dirty = 1;
+
+static void prepare_sprite_lines(void)
+{
+  struct PicoVideo *pv = &Pico.video;
+  unsigned char *sat;
+  int i, h, y, l;
+
+  sat = (unsigned char *)Pico.vram + ((pv->reg[5] & 0x7e) << 7);
+  h = (pv->reg[1] & 2) ? 16 : 8;
+
+  for (l = 0; l < 256; l++)
+    sprite_lines[l][0] = 0;
+
+  for (i = 0; i < 64; i++)
   {
-    PLANAR_PIXEL(0, 7)
-    PLANAR_PIXEL(1, 6)
-    PLANAR_PIXEL(2, 5)
-    PLANAR_PIXEL(3, 4)
-    PLANAR_PIXEL(4, 3)
-    PLANAR_PIXEL(5, 2)
-    PLANAR_PIXEL(6, 1)
-    PLANAR_PIXEL(7, 0)
-    return 0;
+    y = sat[i] + 1;
+    if (y == 0xd1)
+      break;
+
+    for (l = y; l < y + h && l < 256; l++) {
+      unsigned char *sl = sprite_lines[l];
+      if (sl[0] < 8)
+        sl[++sl[0]] = i;
+    }
   }
 
-  return 1; /* Tile blank */
+  sprite_lines_reg1 = pv->reg[1] & 2;
+  sprite_lines_reg5 = pv->reg[5] & 0x7e;
+  mode4_sat_dirty = 0;
 }
 
 static void draw_sprites(int scanline)
 {
   struct PicoVideo *pv = &Pico.video;
-  unsigned int sprites_addr[8];
-  unsigned int sprites_x[8];
-  unsigned char *sat;
+  unsigned char *sat, *sl;
   int xoff = 8; // relative to HighCol, which is (screen - 8)
   int sprite_base, addr_mask;
-  int i, s, h;
+  int i, s, y;
+
+  if (mode4_sat_dirty || (pv->reg[1] & 2) != sprite_lines_reg1
+      || (pv->reg[5] & 0x7e) != sprite_lines_reg5)
+    prepare_sprite_lines();
+
+  sl = sprite_lines[scanline & 0xff];
+  if (sl[0] == 0)
+    return;
 
   if (pv->reg[0] & 8)
     xoff = 0;
 
   sat = (unsigned char *)Pico.vram + ((pv->reg[5] & 0x7e) << 7);
-  if (pv->reg[1] & 2) {
-    addr_mask = 0xfe; h = 16;
-  } else {
-    addr_mask = 0xff; h = 8;
-  }
+  addr_mask = (pv->reg[1] & 2) ? 0xfe : 0xff;
   sprite_base = (pv->reg[6] & 4) << (13-2-1);
 
-  for (i = s = 0; i < 64 && s < 8; i++)
+  // draw all sprites backwards
+  for (s = sl[0]; s > 0; s--)
   {
-    int y;
+    i = sl[s];
     y = sat[i] + 1;
-    if (y == 0xd1)
-      break;
-    if (y + h <= scanline || scanline < y)
-      continue; // not on this line
-
-    sprites_x[s] = xoff + sat[0x80 + i*2];
-    sprites_addr[s] = sprite_base + ((sat[0x80 + i*2 + 1] & addr_mask) << (5-1)) +
-      ((scanline - y) << (2-1));
-    s++;
+    TileNormM4(xoff + sat[0x80 + i*2], sprite_base +
+      ((sat[0x80 + i*2 + 1] & addr_mask) << (5-1)) +
+      ((scanline - y) << (2-1)), 0x10);
   }
-
-  // now draw all sprites backwards
-  for (--s; s >= 0; s--)
-    TileNormM4(sprites_x[s], sprites_addr[s], 0x10);
 }
 
 // tilex_ty_prio merged to reduce register pressure
@@ -198,6 +230,11 @@ static void DrawDisplayM4(int scanline)
 void PicoFrameStartMode4(void)
 {
   int lines = 192;
+
+  if (!planar_lut_done)
+    init_planar_lut();
+  mode4_sat_dirty = 1;
+
   skip_next_line = 0;
   screen_offset = 24;
   rendstatus = PDRAW_32_COLS;
@@ -268,6 +305,7 @@ void PicoDoHighPal555M4(void)
     *dpal = t;
   }
   HighPal[0xe0] = 0;
+  PicoPalDirtyAll();
 }
 
 static void FinalizeLineRGB555M4(int line)
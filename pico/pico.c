@@ -50,6 +50,7 @@ void PicoExit(void)
 {
   if (PicoAHW & PAHW_MCD)
     PicoExitMCD();
+  PicoDrawThreadExit();
   PicoCartUnload();
   z80_exit();
 
@@ -174,6 +175,9 @@ int PicoReset(void)
   SekSetRealTAS(PicoAHW & PAHW_MCD);
 
   Pico.m.dirtyPal = 1;
+  PicoPalDirtyAll();
+  PicoSprDirtyAll();
+  PicoTileDirtyAll();
 
   Pico.m.z80_bank68k = 0;
   Pico.m.z80_reset = 1;
@@ -224,6 +228,9 @@ void PicoLoopPrepare(void)
   scanlines_total = Pico.m.pal ? 312 : 262;
 
   Pico.m.dirtyPal = 1;
+  PicoPalDirtyAll();
+  PicoSprDirtyAll();
+  PicoTileDirtyAll();
   rendstatus_old = -1;
 }
 
@@ -299,13 +306,40 @@ PICO_INTERNAL void PicoSyncZ80(unsigned int m68k_cycles_done)
     z80_cycle_cnt, z80_cycle_cnt / 288,
     z80_cycle_aim, z80_cycle_aim / 288);
 
-  if (cnt > 0)
-    z80_cycle_cnt += z80_run(cnt);
+  if (cnt > 0) {
+    cnt = z80_run(cnt);
+    z80_cycle_cnt += cnt;
+    pstat_add(PSTAT_Z80_CYCLES, cnt);
+  }
 
   pprof_end(z80);
 }
 
 
+unsigned int PicoStats[PSTAT_COUNT];
+unsigned int PicoStatsCur[PSTAT_COUNT];
+
+static const char * const pstat_names[PSTAT_COUNT] = {
+  "m68k cycles",
+  "z80 cycles",
+  "s68k cycles",
+  "msh2 cycles",
+  "ssh2 cycles",
+  "sh2 drc blocks",
+  "sh2 drc flushes",
+  "dma words",
+  "vdp writes",
+  "poll skips",
+  "sound samples",
+};
+
+const char *PicoStatName(pstat_t which)
+{
+  if ((unsigned int)which >= PSTAT_COUNT)
+    return NULL;
+  return pstat_names[which];
+}
+
 void PicoFrame(void)
 {
   pprof_start(frame);
@@ -333,6 +367,8 @@ void PicoFrame(void)
   PicoFrameHints();
 
 end:
+  memcpy(PicoStats, PicoStatsCur, sizeof(PicoStats));
+  memset(PicoStatsCur, 0, sizeof(PicoStatsCur));
   pprof_end(frame);
 }
 
@@ -69,6 +69,9 @@ extern void *p32x_bios_g, *p32x_bios_m, *p32x_bios_s;
 #define POPT_DIS_IDLE_DET   (1<<19)
 #define POPT_EN_32X         (1<<20)
 #define POPT_EN_PWM         (1<<21)
+#define POPT_EN_DRAW_THREAD (1<<23)
+#define POPT_EN_DRAW_BANDS  (1<<24)
+#define POPT_EN_MCD_FASTCD  (1<<25)
 extern int PicoOpt; // bitfield
 
 #define PAHW_MCD  (1<<0)
@@ -99,6 +102,25 @@ typedef enum { PI_ROM, PI_ISPAL, PI_IS40_CELL, PI_IS240_LINES } pint_t;
 typedef union { int vint; void *vptr; } pint_ret_t;
 void PicoGetInternal(pint_t which, pint_ret_t *ret);
 
+// performance counters, PicoStats has the counts of the last PicoFrame(),
+// frontends can sample it after every frame (see libretro.c)
+typedef enum {
+  PSTAT_M68K_CYCLES,
+  PSTAT_Z80_CYCLES,
+  PSTAT_S68K_CYCLES,
+  PSTAT_MSH2_CYCLES,
+  PSTAT_SSH2_CYCLES,
+  PSTAT_SH2_BLOCKS,   // blocks translated by the SH2 DRC
+  PSTAT_SH2_FLUSHES,  // SH2 DRC cache flushes
+  PSTAT_DMA_WORDS,    // VDP DMA transfer length
+  PSTAT_VDP_WRITES,   // VDP data/control port writes
+  PSTAT_POLL_SKIPS,   // CPUs stopped by poll/idle loop detection
+  PSTAT_SND_SAMPLES,
+  PSTAT_COUNT
+} pstat_t;
+extern unsigned int PicoStats[PSTAT_COUNT];
+const char *PicoStatName(pstat_t which);
+
 // cd/mcd.c
 extern void (*PicoMCDopenTray)(void);
 extern void (*PicoMCDcloseTray)(void);
@@ -153,7 +175,13 @@ int      pm_close(pm_file *fp);
 int PicoCartLoad(pm_file *f,unsigned char **prom,unsigned int *psize,int is_sms);
 int PicoCartInsert(unsigned char *rom, unsigned int romsize, const char *carthw_cfg);
 void PicoCartUnload(void);
+void PicoCartFree(unsigned char *rom);
 extern void (*PicoCartLoadProgressCB)(int percent);
+extern const char *PicoCartCacheDir; // keep unpacked zipped ROMs here if set
+#if !defined(NO_MMAP) && (defined(__linux__) || defined(__APPLE__) || defined(__FreeBSD__))
+#define SHARED_ROM // ROM images can be mmap'ed from files in PicoCartShareDir
+#endif
+extern const char *PicoCartShareDir; // share ROM images between processes through files here
 extern void (*PicoCDLoadProgressCB)(const char *fname, int percent);
 extern int PicoGameLoaded;
 
@@ -169,8 +197,18 @@ typedef enum
 void PicoDrawSetOutFormat(pdso_t which, int use_32x_line_mode);
 void PicoDrawSetOutBuf(void *dest, int increment);
 void PicoDrawSetCallbacks(int (*begin)(unsigned int num), int (*end)(unsigned int num));
-extern void *DrawLineDest;
-extern unsigned char *HighCol;
+// line drawing state, kept per thread where lines may be drawn in parallel.
+// default TLS model, the compiler picks the fast one for executables and one
+// that still works when the library is dlopen'ed (libretro core)
+#if defined(USE_THREADS) && defined(__GNUC__) && defined(__ELF__) \
+ && !defined(_ASM_DRAW_C) && !defined(_ASM_DRAW_C_AMIPS) && !defined(_ASM_32X_DRAW)
+#define PICO_DRAW_MT
+#define PICO_DRAW_TLS __thread
+#else
+#define PICO_DRAW_TLS
+#endif
+extern PICO_DRAW_TLS void *DrawLineDest;
+extern PICO_DRAW_TLS unsigned char *HighCol;
 // utility
 #ifdef _ASM_DRAW_C
 void vidConvCpyRGB565(void *to, void *from, int pixels);
@@ -192,12 +230,14 @@ extern int PicoDrawMask;
 #define PDRAW_PLANE_HI_PRIO (1<<6) // have layer with all hi prio tiles (mk3)
 #define PDRAW_SHHI_DONE     (1<<7) // layer sh/hi already processed
 #define PDRAW_32_COLS       (1<<8) // 32 column mode
-extern int rendstatus, rendstatus_old;
+extern PICO_DRAW_TLS int rendstatus;
+extern int rendstatus_old;
 extern int rendlines;
 extern unsigned short HighPal[0x100];
 
 // draw.c
 void PicoDrawUpdateHighPal(void);
+void PicoDrawInvalidateSprites(void);
 void PicoDrawSetInternalBuf(void *dest, int line_increment);
 
 // draw2.c
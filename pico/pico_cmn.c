@@ -25,6 +25,7 @@
 // sync m68k to SekCycleAim
 static void SekSyncM68k(void)
 {
+  unsigned int cyc_start = SekCycleCnt;
   int cyc_do;
   pprof_start(m68k);
   pevt_log_m68k_o(EVT_RUN_START);
@@ -44,6 +45,7 @@ static void SekSyncM68k(void)
   }
 
   SekCyclesLeft = 0;
+  pstat_add(PSTAT_M68K_CYCLES, SekCycleCnt - cyc_start);
 
   SekTrace(0);
   pevt_log_m68k_o(EVT_RUN_END);
@@ -77,6 +79,9 @@ static int PicoFrameHints(void)
   }
   else skip=PicoSkipFrame;
 
+  if (!skip)
+    PicoDrawThreadFrameStart();
+
   if (Pico.m.pal) {
     line_sample = 68;
     if (pv->reg[1]&8) lines_vis = 240;
@@ -162,14 +167,18 @@ static int PicoFrameHints(void)
     if (Pico.m.dma_xfers) SekCyclesBurn(CheckDMA());
     CPUS_RUN(CYCLES_M68K_LINE);
 
+    // nothing can change this line for the renderer anymore
+    if (DrawThreaded && y < 224)
+      PicoDrawSync(y, 0);
+
     if (PicoLineHook) PicoLineHook();
     pevt_log_m68k_o(EVT_NEXT_LINE);
   }
 
   if (!skip)
   {
-    if (DrawScanline < y)
-      PicoDrawSync(y - 1, 0);
+    PicoDrawSync(y - 1, 0);
+    PicoDrawThreadFrameEnd();
 #ifdef DRAW_FINISH_FUNC
     DRAW_FINISH_FUNC();
 #endif
@@ -414,8 +414,16 @@ struct mcd_misc
   unsigned char  bcram_reg;       // 18: battery-backed RAM cart register
   unsigned char  dmna_ret_2m;
   unsigned char  need_sync;
-  unsigned char  pad3;
-  int pad4[9];
+  unsigned char  wram_dual;       // both word RAM layouts kept up to date
+  unsigned char  cdd_subtick;     // 1c: fast drive block slot in 75Hz period
+  unsigned char  pad5[3];
+  unsigned int   s68k_idle_a;     // 20: s68k idle loop: polled address,
+  unsigned int   s68k_idle_d;     //     loops while (value & mask) == d
+  unsigned int   s68k_idle_mask;  //     (or != d for bne)
+  unsigned char  s68k_idle_sz;    // 2c: polled size, 0 - no memory
+  unsigned char  s68k_idle_cc;    //     loop branch op >> 8, 0 - not idle
+  unsigned char  pad6[2];
+  int pad4[4];
 };
 
 typedef struct
@@ -425,16 +433,8 @@ typedef struct
     unsigned char prg_ram[0x80000];
     unsigned char prg_ram_b[4][0x20000];
   };
-  union {					// 0a0000: 256K
-    struct {
-      unsigned char word_ram2M[0x40000];
-      unsigned char unused0[0x20000];
-    };
-    struct {
-      unsigned char unused1[0x20000];
-      unsigned char word_ram1M[2][0x20000];
-    };
-  };
+  unsigned char unused0[0x20000];		// 0a0000: 128K
+  unsigned char word_ram1M[2][0x20000];		// 0c0000: 256K, 1M layout
   union {					// 100000: 64K
     unsigned char pcm_ram[0x10000];
     unsigned char pcm_ram_b[0x10][0x1000];
@@ -443,6 +443,7 @@ typedef struct
   unsigned char bram[0x2000];			// 110200: 8K
   struct mcd_misc m;				// 112200: misc
   struct mcd_pcm pcm;				// 112240:
+  unsigned char word_ram2M[0x40000];		// 1122c8: 256K, 2M layout
   void *cdda_stream;
   int cdda_type;
   int pcm_mixbuf[PCM_MIXBUF_LEN * 2];
@@ -454,6 +455,11 @@ typedef struct
 // XXX: this will need to be reworked for cart+cd support.
 #define Pico_mcd ((mcd_state *)Pico.rom)
 
+// word RAM: 2M offset <-> 1M bank/offset, bit0 is kept (byteswap safe)
+#define WRAM_1M_BANK(a)    (((a) >> 1) & 1)
+#define WRAM_1M_OFFS(a)    ((((a) >> 1) & ~1) | ((a) & 1))
+#define WRAM_2M_OFFS(b, a) ((((a) & ~1) << 1) | ((b) << 1) | ((a) & 1))
+
 // 32X
 #define P32XS_FM    (1<<15)
 #define P32XS_nCART (1<< 8)
@@ -581,15 +587,40 @@ int CM_compareRun(int cyc, int is_sub);
 // draw.c
 PICO_INTERNAL void PicoFrameStart(void);
 void PicoDrawSync(int to, int blank_last_line);
+enum { DLOG_DRAW, DLOG_VRAM, DLOG_CRAM, DLOG_VSRAM, DLOG_REG };
+extern int DrawThreaded;
+void PicoDrawLog(int type, unsigned int a, unsigned int n);
+void PicoDrawThreadFrameStart(void);
+void PicoDrawThreadFrameEnd(void);
+void PicoDrawThreadExit(void);
 void BackFill(int reg7, int sh);
 void FinalizeLine555(int sh, int line);
 extern int (*PicoScanBegin)(unsigned int num);
 extern int (*PicoScanEnd)(unsigned int num);
-extern int DrawScanline;
+extern PICO_DRAW_TLS int DrawScanline;
 #define MAX_LINE_SPRITES 29
 extern unsigned char HighLnSpr[240][3 + MAX_LINE_SPRITES];
 extern void *DrawLineDestBase;
 extern int DrawLineDestIncrement;
+extern unsigned int HighPalDirty[2];
+// cram entries that need conversion by PicoDoHighPal555()
+#define PicoPalDirtyEntry(i) \
+  HighPalDirty[((i) >> 5) & 1] |= 1u << ((i) & 31)
+#define PicoPalDirtyAll() \
+  HighPalDirty[0] = HighPalDirty[1] = ~0u
+extern unsigned int HighSprDirty[4];
+// sat entries that may have changed since PrepareSprites()
+#define PicoSprDirtyEntry(n) \
+  HighSprDirty[((n) >> 5) & 3] |= 1u << ((n) & 31)
+#define PicoSprDirtyAll() \
+  HighSprDirty[0] = HighSprDirty[1] = HighSprDirty[2] = HighSprDirty[3] = ~0u
+extern unsigned int HighTileValid[2048/32];
+// patterns in the decoded tile cache, a is a vram word address
+#define PicoTileDirtyEntry(a) \
+  HighTileValid[((a) >> 9) & 0x3f] &= ~(1u << (((a) >> 4) & 31))
+#define PicoTileDirtyAll() \
+  memset(HighTileValid, 0, sizeof(HighTileValid))
+void PicoTileDirtyRange(unsigned int a, int n);
 
 // draw2.c
 PICO_INTERNAL void PicoFrameFull();
@@ -599,6 +630,7 @@ void PicoFrameStartMode4(void);
 void PicoLineMode4(int line);
 void PicoDoHighPal555M4(void);
 void PicoDrawSetOutputMode4(pdso_t which);
+extern int mode4_sat_dirty;
 
 // memory.c
 PICO_INTERNAL void PicoMemSetup(void);
@@ -621,6 +653,7 @@ int  cdc_decoder_update(unsigned char header[4]);
 void cdc_reg_w(unsigned char data);
 unsigned char  cdc_reg_r(void);
 unsigned short cdc_host_r(void);
+int  cdc_decoder_idle(void);
 
 // cd/cdd.c
 void cdd_reset(void);
@@ -631,6 +664,10 @@ void cdd_read_data(unsigned char *dst);
 void cdd_read_audio(unsigned int samples);
 void cdd_update(void);
 void cdd_process(void);
+int  cdd_reading_data(void);
+
+// fast drive mode: data track seeks and reads are up to this much faster
+#define CDD_FAST_MULT 8
 
 // cd/cd_image.c
 int load_cd_image(const char *cd_img_name, int *type);
@@ -646,12 +683,18 @@ int gfx_context_load(const unsigned char *state);
 void DmaSlowCell(unsigned int source, unsigned int a, int len, unsigned char inc);
 
 // cd/memory.c
+extern unsigned short pcd_cell_map[0x8000];
+// cell arranged word RAM address -> address in the 1M bank
+#define PCD_CELL_ADDR(a) \
+  (((a) & 3) | (pcd_cell_map[((a) >> 2) & 0x7fff] << 2))
 PICO_INTERNAL void PicoMemSetupCD(void);
 unsigned int PicoRead8_mcd_io(unsigned int a);
 unsigned int PicoRead16_mcd_io(unsigned int a);
 void PicoWrite8_mcd_io(unsigned int a, unsigned int d);
 void PicoWrite16_mcd_io(unsigned int a, unsigned int d);
 void pcd_state_loaded_mem(void);
+void s68k_idle_detect(void);
+void s68k_idle_check(void);
 
 // pico.c
 extern struct Pico Pico;
@@ -665,6 +708,11 @@ PICO_INTERNAL int  CheckDMA(void);
 PICO_INTERNAL void PicoDetectRegion(void);
 PICO_INTERNAL void PicoSyncZ80(unsigned int m68k_cycles_done);
 
+// counters of the frame being emulated, no locking, so helper threads may
+// lose an occasional count
+extern unsigned int PicoStatsCur[PSTAT_COUNT];
+#define pstat_add(which, n) PicoStatsCur[which] += (n)
+
 // cd/mcd.c
 #define PCDS_IEN1     (1<<1)
 #define PCDS_IEN2     (1<<2)
@@ -778,6 +826,34 @@ PICO_INTERNAL_ASM void memcpy16bswap(unsigned short *dest, void *src, int count)
 PICO_INTERNAL_ASM void memcpy32(int *dest, int *src, int count); // 32bit word count
 PICO_INTERNAL_ASM void memset32(int *dest, int c, int count);
 
+// thread.c
+typedef void (pico_thread_func)(void *arg);
+struct pico_thread *pico_thread_create(void);
+void pico_thread_destroy(struct pico_thread *t);
+void pico_thread_run(struct pico_thread *t, pico_thread_func *func, void *arg);
+void pico_thread_wait(struct pico_thread *t);
+
+// event.c
+#define PICO_EVENTS_MAX 8
+// compile time check that a queue with 'count' events fits
+#define PICO_EVENTS_CHECK(name, count) \
+  typedef char name##_events_fit[(count) <= PICO_EVENTS_MAX ? 1 : -1]
+typedef void (pico_event_cb)(unsigned int now);
+struct pico_events {
+  unsigned int *times;       // due time of each event, 0 if not scheduled
+  pico_event_cb * const *cbs;
+  int count;
+  const char *name;          // for logging
+  int el_mask;
+  unsigned int next;         // time of the next event, 0 if none
+  int len;
+  unsigned char heap[PICO_EVENTS_MAX]; // scheduled events, ordered by time
+  unsigned char pos[PICO_EVENTS_MAX];  // heap index + 1 of each event, 0 if none
+};
+void pico_events_rebuild(struct pico_events *ev);
+void pico_events_schedule(struct pico_events *ev, int event, unsigned int when);
+void pico_events_run(struct pico_events *ev, unsigned int until);
+
 // eeprom.c
 void EEPROM_write8(unsigned int a, unsigned int d);
 void EEPROM_write16(unsigned int d);
@@ -791,8 +867,9 @@ PICO_INTERNAL void z80_reset(void);
 PICO_INTERNAL void z80_exit(void);
 
 // cd/misc.c
-PICO_INTERNAL_ASM void wram_2M_to_1M(unsigned char *m);
-PICO_INTERNAL_ASM void wram_1M_to_2M(unsigned char *m);
+PICO_INTERNAL_ASM void wram_2M_to_1M(const unsigned char *m2M, unsigned char *m1M);
+PICO_INTERNAL void wram_2M_to_1M_range(unsigned int a, int len);
+PICO_INTERNAL void wram_1M_to_2M_range(int bank, unsigned int a, int len);
 
 // sound/sound.c
 PICO_INTERNAL void PsndReset(void);
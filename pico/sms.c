@@ -48,6 +48,9 @@ static void vdp_data_write(unsigned char d)
     Pico.m.dirtyPal = 1;
   } else {
     Pico.vramb[pv->addr] = d;
+    // sprite y table
+    if (((pv->addr - ((pv->reg[5] & 0x7e) << 7)) & 0x3fff) < 0x40)
+      mode4_sat_dirty = 1;
   }
   pv->addr = (pv->addr + 1) & 0x3fff;
 
@@ -136,10 +139,12 @@ static void z80_sms_out(unsigned short a, unsigned char d)
 
     case 0x80:
       vdp_data_write(d);
+      pstat_add(PSTAT_VDP_WRITES, 1);
       break;
 
     case 0x81:
       vdp_ctl_write(d);
+      pstat_add(PSTAT_VDP_WRITES, 1);
       break;
   }
 }
@@ -298,6 +303,7 @@ void PicoFrameMS(void)
     cycles_aim += cycles_line;
     cycles_done += z80_run((cycles_aim - cycles_done) >> 8) << 8;
   }
+  pstat_add(PSTAT_Z80_CYCLES, cycles_done >> 8);
 
   if (PsndOut)
     PsndGetSamplesMS();
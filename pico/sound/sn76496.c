@@ -20,6 +20,7 @@
 #pragma warning (disable:4244)
 #endif
 
+#include <string.h>
 #include "sn76496.h"
 
 #define MAX_OUTPUT 0x47ff // was 0x7fff
@@ -174,62 +175,91 @@ WRITE8_HANDLER( SN76496_3_w ) {	SN76496Write(3,data); }
 WRITE8_HANDLER( SN76496_4_w ) {	SN76496Write(4,data); }
 */
 
-//static
-void SN76496Update(short *buffer, int length, int stereo)
+/* Between edges a channel output is constant, so whole runs of samples */
+/* are added to the accumulator at once; only samples containing an edge */
+/* go through the exact per-sample integration. */
+#define SN_CHUNK 256
+
+static void SN76496RunTone(struct SN76496 *R, int i, unsigned int *acc, int length)
 {
-	int i;
-	struct SN76496 *R = &ono_sn;
+	unsigned int v;
+	int s = 0, n, vol;
 
-	/* If the volume is 0, increase the counter */
-	for (i = 0;i < 4;i++)
+	while (s < length)
 	{
-		if (R->Volume[i] == 0)
+		/* samples before the next edge */
+		n = (R->Count[i] - 1) / STEP;
+		if (n > length - s) n = length - s;
+		if (n > 0)
 		{
-			/* note that I do count += length, NOT count = length + 1. You might think */
-			/* it's the same since the volume is 0, but doing the latter could cause */
-			/* interferencies when the program is rapidly modulating the volume. */
-			if (R->Count[i] <= length*STEP) R->Count[i] += length*STEP;
+			R->Count[i] -= n * STEP;
+			if (R->Output[i] && R->Volume[i])
+			{
+				v = STEP * R->Volume[i];
+				for (; n > 0; n--)
+					acc[s++] += v;
+			}
+			else
+				s += n;
+			continue;
 		}
-	}
 
-	while (length > 0)
-	{
-		int vol[4];
-		unsigned int out;
-		int left;
+		/* vol keeps track of how long the square wave stays */
+		/* in the 1 position during the sample period. */
+		vol = 0;
+		if (R->Output[i]) vol += R->Count[i];
+		R->Count[i] -= STEP;
+		/* Period[i] is the half period of the square wave. Here, in each */
+		/* loop I add Period[i] twice, so that at the end of the loop the */
+		/* square wave is in the same status (0 or 1) it was at the start. */
+		/* vol is also incremented by Period[i], since the wave has been 1 */
+		/* exactly half of the time, regardless of the initial position. */
+		/* If we exit the loop in the middle, Output[i] has to be inverted */
+		/* and vol incremented only if the exit status of the square */
+		/* wave is 1. */
+		while (R->Count[i] <= 0)
+		{
+			R->Count[i] += R->Period[i];
+			if (R->Count[i] > 0)
+			{
+				R->Output[i] ^= 1;
+				if (R->Output[i]) vol += R->Period[i];
+				break;
+			}
+			R->Count[i] += R->Period[i];
+			vol += R->Period[i];
+		}
+		if (R->Output[i]) vol -= R->Count[i];
 
+		acc[s++] += vol * R->Volume[i];
+	}
+}
 
-		/* vol[] keeps track of how long each square wave stays */
-		/* in the 1 position during the sample period. */
-		vol[0] = vol[1] = vol[2] = vol[3] = 0;
+static void SN76496RunNoise(struct SN76496 *R, unsigned int *acc, int length)
+{
+	unsigned int v;
+	int s = 0, n, vol, left;
 
-		for (i = 0;i < 3;i++)
+	while (s < length)
+	{
+		/* samples before the next shift */
+		n = (R->Count[3] - 1) / STEP;
+		if (n > length - s) n = length - s;
+		if (n > 0)
 		{
-			if (R->Output[i]) vol[i] += R->Count[i];
-			R->Count[i] -= STEP;
-			/* Period[i] is the half period of the square wave. Here, in each */
-			/* loop I add Period[i] twice, so that at the end of the loop the */
-			/* square wave is in the same status (0 or 1) it was at the start. */
-			/* vol[i] is also incremented by Period[i], since the wave has been 1 */
-			/* exactly half of the time, regardless of the initial position. */
-			/* If we exit the loop in the middle, Output[i] has to be inverted */
-			/* and vol[i] incremented only if the exit status of the square */
-			/* wave is 1. */
-			while (R->Count[i] <= 0)
+			R->Count[3] -= n * STEP;
+			if (R->Output[3] && R->Volume[3])
 			{
-				R->Count[i] += R->Period[i];
-				if (R->Count[i] > 0)
-				{
-					R->Output[i] ^= 1;
-					if (R->Output[i]) vol[i] += R->Period[i];
-					break;
-				}
-				R->Count[i] += R->Period[i];
-				vol[i] += R->Period[i];
+				v = STEP * R->Volume[3];
+				for (; n > 0; n--)
+					acc[s++] += v;
 			}
-			if (R->Output[i]) vol[i] -= R->Count[i];
+			else
+				s += n;
+			continue;
 		}
 
+		vol = 0;
 		left = STEP;
 		do
 		{
@@ -238,7 +268,7 @@ void SN76496Update(short *buffer, int length, int stereo)
 			if (R->Count[3] < left) nextevent = R->Count[3];
 			else nextevent = left;
 
-			if (R->Output[3]) vol[3] += R->Count[3];
+			if (R->Output[3]) vol += R->Count[3];
 			R->Count[3] -= nextevent;
 			if (R->Count[3] <= 0)
 			{
@@ -246,24 +276,58 @@ void SN76496Update(short *buffer, int length, int stereo)
 				R->RNG >>= 1;
 				R->Output[3] = R->RNG & 1;
 				R->Count[3] += R->Period[3];
-				if (R->Output[3]) vol[3] += R->Period[3];
+				if (R->Output[3]) vol += R->Period[3];
 			}
-			if (R->Output[3]) vol[3] -= R->Count[3];
+			if (R->Output[3]) vol -= R->Count[3];
 
 			left -= nextevent;
 		} while (left > 0);
 
-		out = vol[0] * R->Volume[0] + vol[1] * R->Volume[1] +
-				vol[2] * R->Volume[2] + vol[3] * R->Volume[3];
+		acc[s++] += vol * R->Volume[3];
+	}
+}
+
+//static
+void SN76496Update(short *buffer, int length, int stereo)
+{
+	unsigned int acc[SN_CHUNK];
+	unsigned int out;
+	int i, n;
+	struct SN76496 *R = &ono_sn;
+
+	/* If the volume is 0, increase the counter */
+	for (i = 0;i < 4;i++)
+	{
+		if (R->Volume[i] == 0)
+		{
+			/* note that I do count += length, NOT count = length + 1. You might think */
+			/* it's the same since the volume is 0, but doing the latter could cause */
+			/* interferencies when the program is rapidly modulating the volume. */
+			if (R->Count[i] <= length*STEP) R->Count[i] += length*STEP;
+		}
+	}
+
+	while (length > 0)
+	{
+		n = length < SN_CHUNK ? length : SN_CHUNK;
 
-		if (out > MAX_OUTPUT * STEP) out = MAX_OUTPUT * STEP;
+		memset(acc, 0, n * sizeof(acc[0]));
+		for (i = 0;i < 3;i++)
+			SN76496RunTone(R, i, acc, n);
+		SN76496RunNoise(R, acc, n);
 
-		if ((out /= STEP)) // will be optimized to shift; max 0x47ff = 18431
-			*buffer += out;
-		if(stereo) buffer+=2; // only left for stereo, to be mixed to right later
-		else buffer++;
+		for (i = 0;i < n;i++)
+		{
+			out = acc[i];
+			if (out > MAX_OUTPUT * STEP) out = MAX_OUTPUT * STEP;
+
+			if ((out /= STEP)) // will be optimized to shift; max 0x47ff = 18431
+				*buffer += out;
+			if(stereo) buffer+=2; // only left for stereo, to be mixed to right later
+			else buffer++;
+		}
 
-		length--;
+		length -= n;
 	}
 }
 
@@ -271,6 +271,8 @@ static int PsndRender(int offset, int length)
   }
 #endif
 
+  pstat_add(PSTAT_SND_SAMPLES, length);
+
   // PSG
   if (PicoOpt & POPT_EN_PSG)
     SN76496Update(PsndOut+offset, length, stereo);
@@ -366,6 +368,8 @@ PICO_INTERNAL void PsndGetSamplesMS(void)
   }
 #endif
 
+  pstat_add(PSTAT_SND_SAMPLES, length);
+
   // PSG
   if (PicoOpt & POPT_EN_PSG)
     SN76496Update(PsndOut, length, stereo);
@@ -38,9 +38,277 @@ static size_t gzWrite2(void *p, size_t _size, size_t _n, void *file)
   return gzwrite(file, p, _size * _n);
 }
 
-static void set_cbs(int gz)
+/*
+ * block compressed container: "PZB1" followed by blocks of
+ * u32 raw_len, u32 comp_len, zlib stream. Saves are collected in memory
+ * and the blocks compressed in parallel with a fast zlib level; loads
+ * inflate straight into the destination of each areaRead.
+ */
+#define ZB_MAGIC "PZB1"
+#define ZB_BLOCK_SIZE (256*1024)
+#define ZB_LEVEL 1
+
+struct zb_file {
+  FILE *f;
+  int is_save;
+  // save
+  unsigned char *buf;
+  size_t len, size;
+  // load
+  z_stream zs;
+  unsigned int comp_left;
+  int in_block;
+  int eof;
+  unsigned char in[16*1024];
+};
+
+struct zb_job {
+  unsigned char *src;
+  size_t src_len;
+  unsigned char **dst;
+  uLongf *dst_len;
+  int start, count;
+  int ret;
+};
+
+static void zb_compress_job(void *arg)
+{
+  struct zb_job *j = arg;
+  size_t l;
+  int i;
+
+  for (i = j->start; i < j->count; i += 2) {
+    l = j->src_len - (size_t)i * ZB_BLOCK_SIZE;
+    if (l > ZB_BLOCK_SIZE)
+      l = ZB_BLOCK_SIZE;
+    j->dst_len[i] = compressBound(l);
+    j->dst[i] = malloc(j->dst_len[i]);
+    if (j->dst[i] == NULL || compress2(j->dst[i], &j->dst_len[i],
+          j->src + (size_t)i * ZB_BLOCK_SIZE, l, ZB_LEVEL) != Z_OK)
+      j->ret = -1;
+  }
+}
+
+static int zb_flush(struct zb_file *zf)
+{
+  int count = (zf->len + ZB_BLOCK_SIZE - 1) / ZB_BLOCK_SIZE;
+  struct pico_thread *thread = NULL;
+  struct zb_job jobs[2];
+  unsigned char **dst;
+  uLongf *dst_len;
+  unsigned int hdr[2];
+  int i, ret = -1;
+
+  dst = calloc(count + 1, sizeof(dst[0]));
+  dst_len = calloc(count + 1, sizeof(dst_len[0]));
+  if (dst == NULL || dst_len == NULL)
+    goto out;
+
+  for (i = 0; i < 2; i++) {
+    jobs[i].src = zf->buf;
+    jobs[i].src_len = zf->len;
+    jobs[i].dst = dst;
+    jobs[i].dst_len = dst_len;
+    jobs[i].start = i;
+    jobs[i].count = count;
+    jobs[i].ret = 0;
+  }
+
+  // odd blocks on a helper, if there is more than one
+  if (count > 1)
+    thread = pico_thread_create();
+  if (thread != NULL)
+    pico_thread_run(thread, zb_compress_job, &jobs[1]);
+  zb_compress_job(&jobs[0]);
+  if (thread != NULL) {
+    pico_thread_wait(thread);
+    pico_thread_destroy(thread);
+  }
+  else
+    zb_compress_job(&jobs[1]);
+  if (jobs[0].ret != 0 || jobs[1].ret != 0)
+    goto out;
+
+  if (fwrite(ZB_MAGIC, 1, 4, zf->f) != 4)
+    goto out;
+  for (i = 0; i < count; i++) {
+    hdr[0] = zf->len - (size_t)i * ZB_BLOCK_SIZE;
+    if (hdr[0] > ZB_BLOCK_SIZE)
+      hdr[0] = ZB_BLOCK_SIZE;
+    hdr[1] = dst_len[i];
+    if (fwrite(hdr, 1, sizeof(hdr), zf->f) != sizeof(hdr))
+      goto out;
+    if (fwrite(dst[i], 1, dst_len[i], zf->f) != dst_len[i])
+      goto out;
+  }
+  ret = 0;
+
+out:
+  if (dst != NULL) {
+    for (i = 0; i < count; i++)
+      free(dst[i]);
+    free(dst);
+  }
+  free(dst_len);
+  return ret;
+}
+
+static size_t zbWrite(void *p, size_t _size, size_t _n, void *file)
+{
+  struct zb_file *zf = file;
+  size_t len = _size * _n;
+  void *tmp;
+
+  if (zf->len + len > zf->size) {
+    size_t size = zf->size ? zf->size * 2 : ZB_BLOCK_SIZE;
+    while (size < zf->len + len)
+      size *= 2;
+    tmp = realloc(zf->buf, size);
+    if (tmp == NULL)
+      return 0;
+    zf->buf = tmp;
+    zf->size = size;
+  }
+  memcpy(zf->buf + zf->len, p, len);
+  zf->len += len;
+
+  return len;
+}
+
+static size_t zbRead(void *p, size_t _size, size_t _n, void *file)
+{
+  struct zb_file *zf = file;
+  unsigned int hdr[2];
+  size_t got;
+  int ret;
+
+  zf->zs.next_out = p;
+  zf->zs.avail_out = _size * _n;
+  while (zf->zs.avail_out > 0 && !zf->eof)
+  {
+    if (!zf->in_block) {
+      if (fread(hdr, 1, sizeof(hdr), zf->f) != sizeof(hdr)) {
+        zf->eof = 1;
+        break;
+      }
+      zf->comp_left = hdr[1];
+      zf->in_block = 1;
+      inflateReset(&zf->zs);
+    }
+    if (zf->zs.avail_in == 0) {
+      got = sizeof(zf->in);
+      if (got > zf->comp_left)
+        got = zf->comp_left;
+      got = fread(zf->in, 1, got, zf->f);
+      if (got == 0) {
+        zf->eof = 1;
+        break;
+      }
+      zf->comp_left -= got;
+      zf->zs.next_in = zf->in;
+      zf->zs.avail_in = got;
+    }
+
+    ret = inflate(&zf->zs, Z_NO_FLUSH);
+    if (ret == Z_STREAM_END)
+      zf->in_block = 0;
+    else if (ret != Z_OK) {
+      elprintf(EL_STATUS, "state: inflate error %d", ret);
+      zf->eof = 1;
+    }
+  }
+
+  return _size * _n - zf->zs.avail_out;
+}
+
+static size_t zbEof(void *file)
+{
+  return ((struct zb_file *)file)->eof;
+}
+
+static int zbSeek(void *file, long offset, int whence)
 {
-  if (gz) {
+  struct zb_file *zf = file;
+  unsigned char skip[256];
+  long l;
+
+  if (zf->is_save)
+    return -1;
+
+  if (whence == SEEK_SET) {
+    if (fseek(zf->f, 4, SEEK_SET) != 0)
+      return -1;
+    zf->zs.avail_in = 0;
+    zf->in_block = zf->eof = 0;
+  }
+  else if (whence != SEEK_CUR || offset < 0)
+    return -1;
+
+  for (; offset > 0; offset -= l) {
+    l = offset < (long)sizeof(skip) ? offset : (long)sizeof(skip);
+    if (zbRead(skip, 1, l, zf) != (size_t)l)
+      return -1;
+  }
+  return 0;
+}
+
+static int zbClose(void *file)
+{
+  struct zb_file *zf = file;
+  int ret = 0;
+
+  if (zf->is_save) {
+    ret = zb_flush(zf);
+    if (ret != 0)
+      elprintf(EL_STATUS, "state: failed to write compressed data");
+    free(zf->buf);
+  }
+  else
+    inflateEnd(&zf->zs);
+  if (fclose(zf->f) != 0)
+    ret = -1;
+  free(zf);
+  return ret;
+}
+
+static struct zb_file *zb_open(FILE *f, int is_save)
+{
+  struct zb_file *zf;
+
+  zf = calloc(1, sizeof(*zf));
+  if (zf == NULL)
+    return NULL;
+  zf->f = f;
+  zf->is_save = is_save;
+  if (!is_save && inflateInit(&zf->zs) != Z_OK) {
+    free(zf);
+    return NULL;
+  }
+  return zf;
+}
+
+static int is_zb_file(FILE *f)
+{
+  char magic[4];
+  int ret;
+
+  ret = fread(magic, 1, 4, f) == 4 && memcmp(magic, ZB_MAGIC, 4) == 0;
+  if (!ret)
+    fseek(f, 0, SEEK_SET);
+  return ret;
+}
+
+enum { AREA_STDIO, AREA_GZ, AREA_ZB };
+
+static void set_cbs(int type)
+{
+  if (type == AREA_ZB) {
+    areaRead  = zbRead;
+    areaWrite = zbWrite;
+    areaEof   = zbEof;
+    areaSeek  = zbSeek;
+    areaClose = zbClose;
+  } else if (type == AREA_GZ) {
     areaRead  = gzRead2;
     areaWrite = gzWrite2;
     areaEof   = (areaeof *) gzeof;
@@ -63,15 +331,29 @@ static void *open_save_file(const char *fname, int is_save)
   if (len > 3 && strcmp(fname + len - 3, ".gz") == 0)
   {
     if ( (afile = gzopen(fname, is_save ? "wb" : "rb")) ) {
-      set_cbs(1);
+      set_cbs(AREA_GZ);
       if (is_save)
         gzsetparams(afile, 9, Z_DEFAULT_STRATEGY);
     }
   }
   else
   {
-    if ( (afile = fopen(fname, is_save ? "wb" : "rb")) ) {
-      set_cbs(0);
+    FILE *f = fopen(fname, is_save ? "wb" : "rb");
+    if (f == NULL)
+      return NULL;
+
+    // block container is written for .pzs, detected by magic on load
+    if (is_save ? (len > 4 && strcmp(fname + len - 4, ".pzs") == 0)
+                : is_zb_file(f))
+    {
+      if ( (afile = zb_open(f, is_save)) )
+        set_cbs(AREA_ZB);
+      else
+        fclose(f);
+    }
+    else {
+      afile = f;
+      set_cbs(AREA_STDIO);
     }
   }
 
@@ -306,8 +588,6 @@ static int state_save(void *file)
 
     memset(buff, 0, sizeof(buff));
     SekPackCpu(buff, 1);
-    if (Pico_mcd->s68k_regs[3] & 4) // 1M mode?
-      wram_1M_to_2M(Pico_mcd->word_ram2M);
     memcpy(&Pico_mcd->m.hint_vector, Pico_mcd->bios + 0x72,
       sizeof(Pico_mcd->m.hint_vector));
 
@@ -329,9 +609,6 @@ static int state_save(void *file)
     CHECKED_WRITE(CHUNK_CD_CDC, len, buf2);
     len = cdd_context_save(buf2);
     CHECKED_WRITE(CHUNK_CD_CDD, len, buf2);
-
-    if (Pico_mcd->s68k_regs[3] & 4) // convert back
-      wram_2M_to_1M(Pico_mcd->word_ram2M);
   }
 
 #ifndef NO_32X
@@ -686,6 +963,9 @@ static int pico_state_internal(void *afile, int is_save)
     if (PicoLoadStateHook != NULL)
       PicoLoadStateHook();
     Pico.m.dirtyPal = 1;
+    PicoPalDirtyAll();
+    PicoSprDirtyAll();
+    PicoTileDirtyAll();
   }
 
   return ret;
@@ -738,6 +1018,9 @@ int PicoStateLoadGfx(const char *fname)
     areaRead(&Pico.video, 1, sizeof(Pico.video), afile);
   }
   areaClose(afile);
+  PicoPalDirtyAll();
+  PicoSprDirtyAll();
+  PicoTileDirtyAll();
   return 0;
 }
 
@@ -793,6 +1076,9 @@ void PicoTmpStateRestore(void *data)
   memcpy(Pico.vsram, t->vsram, sizeof(Pico.vsram));
   memcpy(&Pico.video, &t->video, sizeof(Pico.video));
   Pico.m.dirtyPal = 1;
+  PicoPalDirtyAll();
+  PicoSprDirtyAll();
+  PicoTileDirtyAll();
 
 #ifndef NO_32X
   if (PicoAHW & PAHW_32X) {
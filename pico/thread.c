@@ -0,0 +1,132 @@
+/*
+ * PicoDrive
+ *
+ * This work is licensed under the terms of MAME license.
+ * See COPYING file in the top-level directory.
+ *
+ * Minimal helper threads for jobs that can run off the emulation thread.
+ * A helper runs one job at a time, the caller waits for it to finish.
+ * Without USE_THREADS nothing can be created and callers must fall back
+ * to running the job themselves.
+ */
+#include <stdlib.h>
+#include "pico_int.h"
+
+#ifdef USE_THREADS
+#include <pthread.h>
+
+struct pico_thread {
+  pthread_t thread;
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+  pico_thread_func *func;
+  void *arg;
+  int busy;
+  int quit;
+};
+
+static void *pico_thread_main(void *arg)
+{
+  struct pico_thread *t = arg;
+
+  pthread_mutex_lock(&t->lock);
+  while (1) {
+    while (!t->busy && !t->quit)
+      pthread_cond_wait(&t->cond, &t->lock);
+    if (t->quit)
+      break;
+
+    pthread_mutex_unlock(&t->lock);
+    t->func(t->arg);
+    pthread_mutex_lock(&t->lock);
+
+    t->busy = 0;
+    pthread_cond_broadcast(&t->cond);
+  }
+  pthread_mutex_unlock(&t->lock);
+
+  return NULL;
+}
+
+struct pico_thread *pico_thread_create(void)
+{
+  struct pico_thread *t;
+
+  t = calloc(1, sizeof(*t));
+  if (t == NULL)
+    return NULL;
+
+  pthread_mutex_init(&t->lock, NULL);
+  pthread_cond_init(&t->cond, NULL);
+  if (pthread_create(&t->thread, NULL, pico_thread_main, t) != 0) {
+    elprintf(EL_STATUS, "failed to create helper thread");
+    pthread_cond_destroy(&t->cond);
+    pthread_mutex_destroy(&t->lock);
+    free(t);
+    return NULL;
+  }
+
+  return t;
+}
+
+void pico_thread_destroy(struct pico_thread *t)
+{
+  if (t == NULL)
+    return;
+
+  pthread_mutex_lock(&t->lock);
+  while (t->busy)
+    pthread_cond_wait(&t->cond, &t->lock);
+  t->quit = 1;
+  pthread_cond_broadcast(&t->cond);
+  pthread_mutex_unlock(&t->lock);
+
+  pthread_join(t->thread, NULL);
+  pthread_cond_destroy(&t->cond);
+  pthread_mutex_destroy(&t->lock);
+  free(t);
+}
+
+void pico_thread_run(struct pico_thread *t, pico_thread_func *func, void *arg)
+{
+  pthread_mutex_lock(&t->lock);
+  while (t->busy)
+    pthread_cond_wait(&t->cond, &t->lock);
+  t->func = func;
+  t->arg = arg;
+  t->busy = 1;
+  pthread_cond_broadcast(&t->cond);
+  pthread_mutex_unlock(&t->lock);
+}
+
+void pico_thread_wait(struct pico_thread *t)
+{
+  pthread_mutex_lock(&t->lock);
+  while (t->busy)
+    pthread_cond_wait(&t->cond, &t->lock);
+  pthread_mutex_unlock(&t->lock);
+}
+
+#else // !USE_THREADS
+
+struct pico_thread *pico_thread_create(void)
+{
+  return NULL;
+}
+
+void pico_thread_destroy(struct pico_thread *t)
+{
+}
+
+void pico_thread_run(struct pico_thread *t, pico_thread_func *func, void *arg)
+{
+  func(arg);
+}
+
+void pico_thread_wait(struct pico_thread *t)
+{
+}
+
+#endif
+
+// vim:shiftwidth=2:ts=2:expandtab
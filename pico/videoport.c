@@ -27,20 +27,50 @@ static INLINE void AutoIncrement(void)
   Pico.video.addr=(unsigned short)(Pico.video.addr+Pico.video.reg[0xf]);
 }
 
+// let the renderer know about vram bytes written from a with increment inc
+static void VramWritten(unsigned int a, int len, int inc)
+{
+  if (len <= 0)
+    return;
+  if (DrawThreaded)
+    PicoDrawLog(DLOG_VRAM, (a & 0xffff) >> 1, ((len - 1) * inc + (a & 1) + 3) >> 1);
+  else
+    PicoTileDirtyRange((a & 0xffff) >> 1, ((len - 1) * inc + (a & 1) + 3) >> 1);
+}
+
 static void VideoWrite(u16 d)
 {
   unsigned int a=Pico.video.addr;
+  unsigned int sat;
 
   switch (Pico.video.type)
   {
     case 1: if(a&1) d=(u16)((d<<8)|(d>>8)); // If address is odd, bytes are swapped (which game needs this?)
             Pico.vram [(a>>1)&0x7fff]=d;
-            if (a - ((unsigned)(Pico.video.reg[5]&0x7f) << 9) < 0x400)
+            if (DrawThreaded) {
+              PicoDrawLog(DLOG_VRAM, (a>>1)&0x7fff, 1);
+              break;
+            }
+            PicoTileDirtyEntry((a>>1)&0x7fff);
+            sat = (Pico.video.reg[5]&0x7f) << 9;
+            if (Pico.video.reg[12]&1) sat &= ~0x200; // 40 cell mode
+            if (((a - sat) & 0xffff) < 0x400) {
+              PicoSprDirtyEntry(((a - sat) & 0xffff) >> 3);
               rendstatus |= PDRAW_DIRTY_SPRITES;
+            }
+            break;
+    case 3: Pico.cram [(a>>1)&0x003f]=d; // wraps (Desert Strike)
+            if (DrawThreaded) {
+              PicoDrawLog(DLOG_CRAM, (a>>1)&0x003f, 1);
+              break;
+            }
+            Pico.m.dirtyPal = 1;
+            PicoPalDirtyEntry(a>>1);
+            break;
+    case 5: Pico.vsram[(a>>1)&0x003f]=d;
+            if (DrawThreaded)
+              PicoDrawLog(DLOG_VSRAM, (a>>1)&0x003f, 1);
             break;
-    case 3: Pico.m.dirtyPal = 1;
-            Pico.cram [(a>>1)&0x003f]=d; break; // wraps (Desert Strike)
-    case 5: Pico.vsram[(a>>1)&0x003f]=d; break;
     //default:elprintf(EL_ANOMALY, "VDP write %04x with bad type %i", d, Pico.video.type); break;
   }
 
@@ -81,6 +111,7 @@ static void DmaSlow(int len)
 {
   u16 *pd=0, *pdend, *r;
   unsigned int a=Pico.video.addr, a2, d;
+  int dma_len;
   unsigned char inc=Pico.video.reg[0xf];
   unsigned int source;
 
@@ -93,6 +124,7 @@ static void DmaSlow(int len)
     SekCyclesDone(), SekPc);
 
   Pico.m.dma_xfers += len;
+  pstat_add(PSTAT_DMA_WORDS, len);
   SekCyclesBurnRun(CheckDMA());
 
   if ((source&0xe00000)==0xe00000) { // Ram
@@ -148,6 +180,7 @@ static void DmaSlow(int len)
     len = pdend - pd;
     elprintf(EL_VDPDMA|EL_ANOMALY, "DmaSlow overflow");
   }
+  dma_len = len;
 
   switch (Pico.video.type)
   {
@@ -172,15 +205,22 @@ static void DmaSlow(int len)
           //if(pd >= pdend) pd-=0x8000; // should be good for RAM, bad for ROM
         }
       }
+      VramWritten(Pico.video.addr, dma_len, inc);
+      if (DrawThreaded)
+        break;
+      PicoSprDirtyAll();
       rendstatus |= PDRAW_DIRTY_SPRITES;
       break;
 
     case 3: // cram
-      Pico.m.dirtyPal = 1;
+      if (!DrawThreaded)
+        Pico.m.dirtyPal = 1;
       r = Pico.cram;
       for(a2=a&0x7f; len; len--)
       {
         r[a2>>1] = (u16)*pd++; // bit 0 is ignored
+        if (!DrawThreaded)
+          PicoPalDirtyEntry(a2>>1);
         // AutoIncrement
         a2+=inc;
         // didn't src overlap?
@@ -189,6 +229,8 @@ static void DmaSlow(int len)
         if(a2 >= 0x80) break; // Todds Adventures in Slime World / Andre Agassi tennis
       }
       a=(a&0xff00)|a2;
+      if (DrawThreaded)
+        PicoDrawLog(DLOG_CRAM, 0, 0x40);
       break;
 
     case 5: // vsram[a&0x003f]=d;
@@ -204,6 +246,8 @@ static void DmaSlow(int len)
         if(a2 >= 0x80) break;
       }
       a=(a&0xff00)|a2;
+      if (DrawThreaded)
+        PicoDrawLog(DLOG_VSRAM, 0, 0x40);
       break;
 
     default:
@@ -221,10 +265,11 @@ static void DmaCopy(int len)
   unsigned char *vr = (unsigned char *) Pico.vram;
   unsigned char *vrs;
   unsigned char inc=Pico.video.reg[0xf];
-  int source;
+  int source, count;
   elprintf(EL_VDPDMA, "DmaCopy len %i [%i]", len, SekCyclesDone());
 
   Pico.m.dma_xfers += len;
+  pstat_add(PSTAT_DMA_WORDS, len);
   Pico.video.status |= 2; // dma busy
 
   source =Pico.video.reg[0x15];
@@ -233,14 +278,18 @@ static void DmaCopy(int len)
 
   if (source+len > 0x10000) len=0x10000-source; // clip??
 
-  for (; len; len--)
+  for (count = len; count; count--)
   {
     vr[a] = *vrs++;
     // AutoIncrement
     a=(u16)(a+inc);
   }
+  VramWritten(Pico.video.addr, len, inc);
   // remember addr
   Pico.video.addr=a;
+  if (DrawThreaded)
+    return;
+  PicoSprDirtyAll();
   rendstatus |= PDRAW_DIRTY_SPRITES;
 }
 
@@ -248,7 +297,7 @@ static void DmaCopy(int len)
 // note: this is still inaccurate
 static void DmaFill(int data)
 {
-  int len;
+  int len, count;
   unsigned short a=Pico.video.addr;
   unsigned char *vr=(unsigned char *) Pico.vram;
   unsigned char high = (unsigned char) (data >> 8);
@@ -258,6 +307,7 @@ static void DmaFill(int data)
   elprintf(EL_VDPDMA, "DmaFill len %i inc %i [%i]", len, inc, SekCyclesDone());
 
   Pico.m.dma_xfers += len;
+  pstat_add(PSTAT_DMA_WORDS, len);
   Pico.video.status |= 2; // dma busy
 
   // from Charles MacDonald's genvdp.txt:
@@ -267,7 +317,7 @@ static void DmaFill(int data)
 
   if (!inc) len=1;
 
-  for (; len; len--) {
+  for (count = len; count; count--) {
     // Write upper byte to adjacent address
     // (here we are byteswapped, so address is already 'adjacent')
     vr[a] = high;
@@ -275,11 +325,15 @@ static void DmaFill(int data)
     // Increment address register
     a=(u16)(a+inc);
   }
+  VramWritten(Pico.video.addr, len + 1, inc);
   // remember addr
   Pico.video.addr=a;
   // update length
   Pico.video.reg[0x13] = Pico.video.reg[0x14] = 0; // Dino Dini's Soccer (E) (by Haze)
 
+  if (DrawThreaded)
+    return;
+  PicoSprDirtyAll();
   rendstatus |= PDRAW_DIRTY_SPRITES;
 }
 
@@ -319,7 +373,7 @@ static void CommandChange(void)
 static void DrawSync(int blank_on)
 {
   if (Pico.m.scanline < 224 && !(PicoOpt & POPT_ALT_RENDERER) &&
-      !PicoSkipFrame && DrawScanline <= Pico.m.scanline) {
+      !PicoSkipFrame) {
     //elprintf(EL_ANOMALY, "sync");
     PicoDrawSync(Pico.m.scanline, blank_on);
   }
@@ -331,6 +385,7 @@ PICO_INTERNAL_ASM void PicoVideoWrite(unsigned int a,unsigned short d)
 
   //if (Pico.m.scanline < 224)
   //  elprintf(EL_STATUS, "PicoVideoWrite [%06x] %04x", a, d);
+  pstat_add(PSTAT_VDP_WRITES, 1);
   a&=0x1c;
 
   if (a==0x00) // Data port 0 or 2
@@ -400,6 +455,12 @@ PICO_INTERNAL_ASM void PicoVideoWrite(unsigned int a,unsigned short d)
           blank_on = 1;
         DrawSync(blank_on);
         pvid->reg[num]=(unsigned char)d;
+        if (DrawThreaded) {
+          // render flags are updated by the draw thread
+          PicoDrawLog(DLOG_REG, num, 1);
+          if (num == 0x05 || num == 0x0c)
+            return;
+        }
         switch (num)
         {
           case 0x00:
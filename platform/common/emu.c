@@ -27,6 +27,7 @@
 
 #include <pico/pico_int.h>
 #include <pico/patch.h>
+#include <zlib/zlib.h>
 
 #ifndef _WIN32
 #define PATH_SEP      "/"
@@ -65,6 +66,8 @@ static char noticeMsg[40];
 unsigned char *movie_data = NULL;
 static int movie_size = 0;
 
+static int emu_headless; /* no menu or display, for -bench */
+
 
 /* don't use tolower() for easy old glibc binary compatibility */
 static void strlwr_(char *string)
@@ -359,6 +362,7 @@ int emu_reload_rom(const char *rom_fname_in)
 	enum media_type_e media_type;
 	int menu_romload_started = 0;
 	char carthw_path[512];
+	static char rom_cache_dir[512];
 	int retval = 0;
 
 	lprintf("emu_ReloadRom(%s)\n", rom_fname_in);
@@ -425,10 +429,16 @@ int emu_reload_rom(const char *rom_fname_in)
 		get_ext(rom_fname, ext);
 	}
 
-	menu_romload_prepare(rom_fname); // also CD load
-	menu_romload_started = 1;
+	if (!emu_headless) {
+		menu_romload_prepare(rom_fname); // also CD load
+		menu_romload_started = 1;
+	}
 
 	emu_make_path(carthw_path, "carthw.cfg", sizeof(carthw_path));
+	emu_make_path(rom_cache_dir, "romcache", sizeof(rom_cache_dir));
+	PicoCartCacheDir = NULL;
+	if ((currentConfig.EmuOpt & EOPT_ROM_CACHE) && plat_is_dir(rom_cache_dir))
+		PicoCartCacheDir = rom_cache_dir;
 
 	media_type = PicoLoadMedia(rom_fname, carthw_path,
 			find_bios, do_region_override);
@@ -454,7 +464,8 @@ int emu_reload_rom(const char *rom_fname_in)
 	if (PicoQuirks & PQUIRK_FORCE_6BTN)
 		currentConfig.input_dev0 = PICO_INPUT_PAD_6BTN;
 
-	menu_romload_end();
+	if (menu_romload_started)
+		menu_romload_end();
 	menu_romload_started = 0;
 
 	if (PicoPatches) {
@@ -492,8 +503,9 @@ int emu_reload_rom(const char *rom_fname_in)
 	strncpy(rom_fname_loaded, rom_fname, sizeof(rom_fname_loaded)-1);
 	rom_fname_loaded[sizeof(rom_fname_loaded)-1] = 0;
 
-	// load SRAM for this ROM
-	if (currentConfig.EmuOpt & EOPT_EN_SRAM)
+	// load SRAM for this ROM (the game config may have enabled it,
+	// but the benchmark always starts without)
+	if ((currentConfig.EmuOpt & EOPT_EN_SRAM) && !emu_headless)
 		emu_save_load_game(1, 1);
 
 	// state autoload?
@@ -824,12 +836,13 @@ char *emu_get_save_fname(int load, int is_sram, int slot, int *time)
 	}
 	else
 	{
-		const char *ext_main = (currentConfig.EmuOpt & EOPT_GZIP_SAVES) ? ".mds.gz" : ".mds";
-		const char *ext_othr = (currentConfig.EmuOpt & EOPT_GZIP_SAVES) ? ".mds" : ".mds.gz";
+		static const char * const exts[] = { ".mds", ".mds.gz", ".pzs" };
+		int i, ext_main = (currentConfig.EmuOpt & EOPT_FAST_SAVES) ? 2 :
+			(currentConfig.EmuOpt & EOPT_GZIP_SAVES) ? 1 : 0;
 		ext[0] = 0;
 		if (slot > 0 && slot < 10)
 			sprintf(ext, ".%i", slot);
-		strcat(ext, ext_main);
+		strcat(ext, exts[ext_main]);
 
 		if (!load) {
 			romfname_ext(saveFname, sizeof(static_buff), "mds" PATH_SEP, ext);
@@ -844,15 +857,19 @@ char *emu_get_save_fname(int load, int is_sram, int slot, int *time)
 			if (try_ropen_file(saveFname, time))
 				return saveFname;
 
-			// try the other ext
-			ext[0] = 0;
-			if (slot > 0 && slot < 10)
-				sprintf(ext, ".%i", slot);
-			strcat(ext, ext_othr);
-
-			romfname_ext(saveFname, sizeof(static_buff), "mds"PATH_SEP, ext);
-			if (try_ropen_file(saveFname, time))
-				return saveFname;
+			// try the other exts
+			for (i = 0; i < sizeof(exts) / sizeof(exts[0]); i++) {
+				if (i == ext_main)
+					continue;
+				ext[0] = 0;
+				if (slot > 0 && slot < 10)
+					sprintf(ext, ".%i", slot);
+				strcat(ext, exts[i]);
+
+				romfname_ext(saveFname, sizeof(static_buff), "mds"PATH_SEP, ext);
+				if (try_ropen_file(saveFname, time))
+					return saveFname;
+			}
 		}
 	}
 
@@ -1240,6 +1257,7 @@ void emu_init(void)
 	mkdir_path(path, pos, "srm");
 	mkdir_path(path, pos, "brm");
 	mkdir_path(path, pos, "cfg");
+	mkdir_path(path, pos, "romcache");
 
 	pprof_init();
 
@@ -1518,3 +1536,137 @@ void emu_loop(void)
 	pemu_loop_end();
 	emu_sound_stop();
 }
+
+
+/* headless movie replay for benchmarking and determinism checks */
+static unsigned int bench_snd_crc;
+
+static void bench_snd_write(int len)
+{
+	bench_snd_crc = crc32(bench_snd_crc, (void *)PsndOut, len);
+}
+
+// emulated memory, also that of the add-on hw in use
+static unsigned int bench_mem_crc(void)
+{
+	unsigned int crc;
+
+	crc = crc32(0, (void *)Pico.ram, sizeof(Pico.ram));
+	crc = crc32(crc, (void *)Pico.vram, sizeof(Pico.vram));
+	crc = crc32(crc, (void *)Pico.zram, sizeof(Pico.zram));
+	crc = crc32(crc, (void *)Pico.cram, sizeof(Pico.cram));
+	crc = crc32(crc, (void *)Pico.vsram, sizeof(Pico.vsram));
+#ifndef NO_32X
+	if ((PicoAHW & PAHW_32X) && Pico32xMem != NULL) {
+		crc = crc32(crc, Pico32xMem->sdram, sizeof(Pico32xMem->sdram));
+		crc = crc32(crc, (void *)Pico32xMem->dram, sizeof(Pico32xMem->dram));
+		crc = crc32(crc, (void *)Pico32xMem->pal, sizeof(Pico32xMem->pal));
+	}
+#endif
+	if (PicoAHW & PAHW_MCD) {
+		crc = crc32(crc, Pico_mcd->prg_ram, sizeof(Pico_mcd->prg_ram));
+		crc = crc32(crc, (void *)Pico_mcd->word_ram1M, sizeof(Pico_mcd->word_ram1M));
+		crc = crc32(crc, Pico_mcd->word_ram2M, sizeof(Pico_mcd->word_ram2M));
+	}
+
+	return crc;
+}
+
+static int bench_cmp_ticks(const void *p1, const void *p2)
+{
+	unsigned int t1 = *(const unsigned int *)p1;
+	unsigned int t2 = *(const unsigned int *)p2;
+	return t1 < t2 ? -1 : (t1 > t2);
+}
+
+int emu_bench_movie(const char *movie_fname, int print_hashes)
+{
+	static unsigned short fb[320 * 240];
+	unsigned long long ticks_total = 0;
+	unsigned int *ticks = NULL;
+	unsigned int mem_crc, fb_crc, all_crc = 0;
+	unsigned int t;
+	int old_emuopt = currentConfig.EmuOpt;
+	int old_autoload = g_autostateld_opt;
+	int frames = -1, f, redraw_bad = 0;
+
+	// runs without platform, menu or sound init, see main()
+	emu_headless = 1;
+	PicoInit();
+
+	// start from power on on every machine, whatever was saved before
+	currentConfig.EmuOpt &= ~EOPT_EN_SRAM;
+	g_autostateld_opt = 0;
+
+	if (!emu_reload_rom(movie_fname) || movie_data == NULL) {
+		lprintf("bench: failed to load movie %s\n", movie_fname);
+		goto out;
+	}
+
+	ticks = malloc((movie_size - 0x40) / 3 * sizeof(ticks[0]));
+	if (ticks == NULL)
+		goto out;
+	frames = (movie_size - 0x40) / 3;
+
+	PicoDrawSetOutFormat(PDF_RGB555, 0);
+	PicoDrawSetOutBuf(fb, 320 * 2);
+	PsndRerate(0);
+	PsndOut = sndBuffer;
+	PicoWriteSound = bench_snd_write;
+	PicoLoopPrepare();
+
+	for (f = 0; f < frames && movie_data != NULL; f++)
+	{
+		update_movie();
+		bench_snd_crc = 0;
+
+		t = plat_get_ticks_us();
+		PicoFrame();
+		ticks[f] = plat_get_ticks_us() - t;
+		ticks_total += ticks[f];
+
+		mem_crc = bench_mem_crc();
+		fb_crc = crc32(0, (void *)fb, sizeof(fb));
+		all_crc = crc32(all_crc, (void *)&mem_crc, sizeof(mem_crc));
+		all_crc = crc32(all_crc, (void *)&fb_crc, sizeof(fb_crc));
+		all_crc = crc32(all_crc, (void *)&bench_snd_crc, sizeof(bench_snd_crc));
+		if (print_hashes) {
+			printf("%6d %08x %08x %08x\n", f, mem_crc, fb_crc, bench_snd_crc);
+
+			// the same frame drawn again from the kept sprite line
+			// lists and from rebuilt ones must come out the same
+			PicoFrameDrawOnly();
+			fb_crc = crc32(0, (void *)fb, sizeof(fb));
+			PicoDrawInvalidateSprites();
+			PicoFrameDrawOnly();
+			if (crc32(0, (void *)fb, sizeof(fb)) != fb_crc) {
+				printf("%6d redraw mismatch\n", f);
+				redraw_bad++;
+			}
+		}
+	}
+	frames = f;
+
+	PicoWriteSound = NULL;
+	PsndOut = NULL;
+
+	if (frames > 0) {
+		qsort(ticks, frames, sizeof(ticks[0]), bench_cmp_ticks);
+		printf("bench: %d frames in %llu us, %.2f fps\n", frames, ticks_total,
+			ticks_total ? frames * 1000000.0 / ticks_total : 0.0);
+		printf("bench: frame us p50 %u p90 %u p99 %u max %u\n",
+			ticks[frames * 50 / 100], ticks[frames * 90 / 100],
+			ticks[frames * 99 / 100], ticks[frames - 1]);
+		printf("bench: hash %08x\n", all_crc);
+		if (redraw_bad)
+			printf("bench: %d frames drawn differently when redrawn\n",
+				redraw_bad);
+	}
+
+out:
+	free(ticks);
+	PicoExit();
+	currentConfig.EmuOpt = old_emuopt;
+	g_autostateld_opt = old_autoload;
+	return frames;
+}
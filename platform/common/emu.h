@@ -33,6 +33,8 @@ extern int g_screen_height;
 #define EOPT_NO_FRMLIMIT  (1<<18)
 #define EOPT_WIZ_TEAR_FIX (1<<19)
 #define EOPT_EXT_FRMLIMIT (1<<20) // no internal frame limiter (limited by snd, etc)
+#define EOPT_ROM_CACHE    (1<<21) // keep unpacked zipped ROMs in romcache/
+#define EOPT_FAST_SAVES   (1<<22) // block compressed .pzs savestates, over gzip
 
 enum {
 	EOPT_SCALE_NONE = 0,
@@ -112,6 +114,7 @@ void  emu_finish(void);
 void  emu_loop(void);
 
 int   emu_reload_rom(const char *rom_fname_in);
+int   emu_bench_movie(const char *movie_fname, int print_hashes);
 int   emu_swap_cd(const char *fname);
 int   emu_save_load_game(int load, int sram);
 void  emu_reset_game(void);
@@ -20,6 +20,8 @@
 
 
 static int load_state_slot = -1;
+static const char *bench_movie;
+static int bench_hashes;
 char **g_argv;
 
 void parse_cmd_line(int argc, char *argv[])
@@ -38,6 +40,12 @@ void parse_cmd_line(int argc, char *argv[])
 			{
 				if (x+1 < argc) { ++x; load_state_slot = atoi(argv[x]); }
 			}
+			else if (strcasecmp(argv[x], "-bench") == 0) {
+				if (x+1 < argc) { ++x; bench_movie = argv[x]; }
+			}
+			else if (strcasecmp(argv[x], "-bench_hashes") == 0) {
+				bench_hashes = 1;
+			}
 			else if (strcasecmp(argv[x], "-pdb") == 0) {
 				if (x+1 < argc) { ++x; pdb_command(argv[x]); }
 			}
@@ -66,7 +74,10 @@ void parse_cmd_line(int argc, char *argv[])
 		printf("usage: %s [options] [romfile]\n", argv[0]);
 		printf("options:\n"
 			" -config <file>    use specified config file instead of default 'config.cfg'\n"
-			" -loadstate <num>  if ROM is specified, try loading savestate slot <num>\n");
+			" -loadstate <num>  if ROM is specified, try loading savestate slot <num>\n"
+			" -bench <gmv>      replay movie at full speed, report timing and hashes\n"
+			" -bench_hashes     with -bench, print memory/screen/sound hashes per frame\n"
+			"                   and check that redrawing a frame gives the same screen\n");
 		exit(1);
 	}
 }
@@ -76,6 +87,23 @@ int main(int argc, char *argv[])
 {
 	g_argv = argv;
 
+	engineState = PGS_Menu;
+
+	if (argc > 1)
+		parse_cmd_line(argc, argv);
+
+	if (bench_movie != NULL) {
+		// headless: input tables for the config only, no video/sound/menu
+		in_init();
+		emu_prep_defconfig();
+		emu_read_config(NULL, 0);
+		if (emu_bench_movie(bench_movie, bench_hashes) < 0) {
+			printf("bench failed\n");
+			return 1;
+		}
+		return 0;
+	}
+
 	plat_early_init();
 
 	in_init();
@@ -90,11 +118,6 @@ int main(int argc, char *argv[])
 	emu_init();
 	menu_init();
 
-	engineState = PGS_Menu;
-
-	if (argc > 1)
-		parse_cmd_line(argc, argv);
-
 	if (engineState == PGS_ReloadRom)
 	{
 		if (emu_reload_rom(rom_fname_reload)) {
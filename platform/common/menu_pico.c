@@ -405,6 +405,8 @@ static const char h_srcart[] = "Emulate the save RAM cartridge accessory\n"
 				"most games don't need this";
 static const char h_scfx[]   = "Emulate scale/rotate ASIC chip for graphics effects\n"
 				"disable to improve performance";
+static const char h_fastcd[] = "Faster seeks and data reads, shortens loading\n"
+				"may break timing sensitive games";
 static const char h_bsync[]  = "More accurate mode for CPUs (needed for some games)\n"
 				"disable to improve performance";
 
@@ -415,6 +417,7 @@ static menu_entry e_menu_cd_options[] =
 	mee_onoff_h("PCM audio",            MA_CDOPT_PCM,           PicoOpt, POPT_EN_MCD_PCM, h_cdpcm),
 	mee_onoff_h("SaveRAM cart",         MA_CDOPT_SAVERAM,       PicoOpt, POPT_EN_MCD_RAMCART, h_srcart),
 	mee_onoff_h("Scale/Rot. fx",        MA_CDOPT_SCALEROT_CHIP, PicoOpt, POPT_EN_MCD_GFX, h_scfx),
+	mee_onoff_h("Fast CD drive",        MA_CDOPT_FASTCD,        PicoOpt, POPT_EN_MCD_FASTCD, h_fastcd),
 	mee_end,
 };
 
@@ -497,7 +500,9 @@ static menu_entry e_menu_adv_options[] =
 	mee_onoff     ("Emulate YM2612 (FM)",      MA_OPT2_ENABLE_YM2612, PicoOpt, POPT_EN_FM),
 	mee_onoff     ("Emulate SN76496 (PSG)",    MA_OPT2_ENABLE_SN76496,PicoOpt, POPT_EN_PSG),
 	mee_onoff     ("gzip savestates",          MA_OPT2_GZIP_STATES,   currentConfig.EmuOpt, EOPT_GZIP_SAVES),
+	mee_onoff     ("Fast compressed savestates",MA_OPT2_FAST_STATES,  currentConfig.EmuOpt, EOPT_FAST_SAVES),
 	mee_onoff     ("Don't save last used ROM", MA_OPT2_NO_LAST_ROM,   currentConfig.EmuOpt, EOPT_NO_AUTOSVCFG),
+	mee_onoff     ("Keep unpacked zipped ROMs",MA_OPT2_ROM_CACHE,     currentConfig.EmuOpt, EOPT_ROM_CACHE),
 	mee_onoff     ("Disable idle loop patching",MA_OPT2_NO_IDLE_LOOPS,PicoOpt, POPT_DIS_IDLE_DET),
 	mee_onoff     ("Disable frame limiter",    MA_OPT2_NO_FRAME_LIMIT,currentConfig.EmuOpt, EOPT_NO_FRMLIMIT),
 	mee_onoff     ("Enable dynarecs",          MA_OPT2_DYNARECS,      PicoOpt, POPT_EN_DRC),
@@ -57,6 +57,8 @@ typedef enum
 	MA_OPT2_DYNARECS,
 	MA_OPT2_NO_SPRITE_LIM,
 	MA_OPT2_NO_IDLE_LOOPS,
+	MA_OPT2_ROM_CACHE,
+	MA_OPT2_FAST_STATES,
 	MA_OPT2_DONE,
 	MA_OPT3_SCALE,		/* psp (all OPT3) */
 	MA_OPT3_HSCALE32,
@@ -81,6 +83,7 @@ typedef enum
 	MA_CDOPT_READAHEAD,
 	MA_CDOPT_SAVERAM,
 	MA_CDOPT_SCALEROT_CHIP,
+	MA_CDOPT_FASTCD,
 	MA_CDOPT_DONE,
 	MA_32XOPT_ENABLE_32X,
 	MA_32XOPT_RENDERER,
@@ -63,6 +63,12 @@ static short __attribute__((aligned(4))) sndBuffer[2*44100/50];
 
 static void snd_write(int len);
 
+/* performance counters, sampled every frame */
+static int stats_mode; /* 0 off, 1 log every second, 2 log on unload */
+static unsigned int stats_frames, stats_sec_frames;
+static unsigned long long stats_total[PSTAT_COUNT];
+static unsigned long long stats_sec[PSTAT_COUNT];
+
 #ifdef _WIN32
 #define SLASH '\\'
 #else
@@ -479,9 +485,21 @@ void retro_set_environment(retro_environment_t cb)
 		{ "picodrive_input2", "Input device 2; 3 button pad|6 button pad|None" },
 		{ "picodrive_sprlim", "No sprite limit; disabled|enabled" },
 		{ "picodrive_ramcart", "MegaCD RAM cart; disabled|enabled" },
+		{ "picodrive_fastcd", "MegaCD fast CD drive; disabled|enabled" },
 		{ "picodrive_region", "Region; Auto|Japan NTSC|Japan PAL|US|Europe" },
+		{ "picodrive_stats", "Log performance counters; disabled|every second|on unload" },
+#ifdef SHARED_ROM
+		{ "picodrive_sharedrom", "Share ROM memory between instances; disabled|enabled" },
+#endif
 #ifdef DRC_SH2
 		{ "picodrive_drc", "Dynamic recompilers; enabled|disabled" },
+#endif
+#ifdef USE_THREADS
+#ifdef PICO_DRAW_MT
+		{ "picodrive_drawthread", "Draw on separate threads; disabled|enabled|bands" },
+#else
+		{ "picodrive_drawthread", "Draw on a separate thread; disabled|enabled" },
+#endif
 #endif
 		{ NULL, NULL },
 	};
@@ -1026,8 +1044,52 @@ bool retro_load_game_special(unsigned game_type, const struct retro_game_info *i
 	return false;
 }
 
+static void stats_sample(void)
+{
+	char buf[512];
+	int i, len = 0;
+
+	for (i = 0; i < PSTAT_COUNT; i++) {
+		stats_total[i] += PicoStats[i];
+		stats_sec[i] += PicoStats[i];
+	}
+	stats_frames++;
+
+	if (stats_mode != 1 || ++stats_sec_frames < (Pico.m.pal ? 50 : 60))
+		return;
+
+	/* per frame averages over the last second */
+	for (i = 0; i < PSTAT_COUNT && len < sizeof(buf); i++)
+		len += snprintf(buf + len, sizeof(buf) - len, "%s%s %llu",
+			i ? ", " : "", PicoStatName(i), stats_sec[i] / stats_sec_frames);
+	if (log_cb)
+		log_cb(RETRO_LOG_INFO, "per frame: %s\n", buf);
+
+	memset(stats_sec, 0, sizeof(stats_sec));
+	stats_sec_frames = 0;
+}
+
+static void stats_report(void)
+{
+	int i;
+
+	if (stats_frames == 0 || !log_cb)
+		return;
+
+	log_cb(RETRO_LOG_INFO, "performance counters, %u frames (total, per frame):\n",
+		stats_frames);
+	for (i = 0; i < PSTAT_COUNT; i++)
+		log_cb(RETRO_LOG_INFO, "  %-16s %14llu %10llu\n", PicoStatName(i),
+			stats_total[i], stats_total[i] / stats_frames);
+
+	memset(stats_total, 0, sizeof(stats_total));
+	memset(stats_sec, 0, sizeof(stats_sec));
+	stats_frames = stats_sec_frames = 0;
+}
+
 void retro_unload_game(void) 
 {
+	stats_report();
 }
 
 unsigned retro_get_region(void)
@@ -1141,6 +1203,31 @@ static void update_variables(void)
 			PicoOpt &= ~POPT_EN_MCD_RAMCART;
 	}
 
+	var.value = NULL;
+	var.key = "picodrive_fastcd";
+	if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value) {
+		if (strcmp(var.value, "enabled") == 0)
+			PicoOpt |= POPT_EN_MCD_FASTCD;
+		else
+			PicoOpt &= ~POPT_EN_MCD_FASTCD;
+	}
+
+#ifdef SHARED_ROM
+	var.value = NULL;
+	var.key = "picodrive_sharedrom";
+	if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value) {
+		static char share_dir[256];
+		const char *dir = NULL;
+
+		PicoCartShareDir = NULL;
+		if (strcmp(var.value, "enabled") == 0
+		    && environ_cb(RETRO_ENVIRONMENT_GET_SYSTEM_DIRECTORY, &dir) && dir) {
+			snprintf(share_dir, sizeof(share_dir), "%s", dir);
+			PicoCartShareDir = share_dir;
+		}
+	}
+#endif
+
 	var.value = NULL;
 	var.key = "picodrive_region";
 	if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value) {
@@ -1156,6 +1243,12 @@ static void update_variables(void)
 			PicoRegionOverride = 8;
 	}
 
+	var.value = NULL;
+	var.key = "picodrive_stats";
+	if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+		stats_mode = strcmp(var.value, "every second") == 0 ? 1 :
+			strcmp(var.value, "on unload") == 0 ? 2 : 0;
+
 #ifdef DRC_SH2
 	var.value = NULL;
 	var.key = "picodrive_drc";
@@ -1170,6 +1263,17 @@ static void update_variables(void)
    if(!ctr_svchack_successful)
       PicoOpt &= ~POPT_EN_DRC;
 #endif
+#ifdef USE_THREADS
+	var.value = NULL;
+	var.key = "picodrive_drawthread";
+	if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value) {
+		PicoOpt &= ~(POPT_EN_DRAW_THREAD|POPT_EN_DRAW_BANDS);
+		if (strcmp(var.value, "enabled") == 0)
+			PicoOpt |= POPT_EN_DRAW_THREAD;
+		else if (strcmp(var.value, "bands") == 0)
+			PicoOpt |= POPT_EN_DRAW_BANDS;
+	}
+#endif
 }
 
 void retro_run(void) 
@@ -1190,6 +1294,9 @@ void retro_run(void)
 
 	PicoFrame();
 
+	if (stats_mode)
+		stats_sample();
+
 	video_cb((short *)vout_buf + vout_offset,
 		vout_width, vout_height, vout_width * 2);
 }